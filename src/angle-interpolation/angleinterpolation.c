@@ -82,6 +82,67 @@ float interpolateAngleFromFittedCurve(  float angleToInterpolateInDegree,
     return modulo((angleToInterpolateInDegree-angleError)+zeroDegreeOffset, 360.0);
 }
 
+float interpolateAngleFromCubicCoefficients(   float angleToInterpolateInDegree,
+                                                float cubicCoefficients[],
+                                                const unsigned int lookupTableSize,
+                                                float zeroDegreeOffset,
+                                                float *pAngleError)
+{
+    float angleError;
+    unsigned int lookupTableIndex;
+    float position;
+    float segment;
+    float t;
+    float *c;
+    position = modulo(angleToInterpolateInDegree, 360.0)*((float)lookupTableSize/360.0f);
+    segment = floorf(position);
+    t = position-segment;
+    lookupTableIndex = moduloInt((int)segment, lookupTableSize);
+    c = &cubicCoefficients[4*lookupTableIndex];
+    //Horner's scheme
+    angleError = ((c[3]*t+c[2])*t+c[1])*t+c[0];
+    *pAngleError=angleError;
+    return modulo((angleToInterpolateInDegree-angleError)+zeroDegreeOffset, 360.0);
+}
+
+void interpolateAngleArrayFromCubicCoefficients(float anglesToInterpolateInDegree[],
+                                                float correctedAnglesInDegree[],
+                                                float angleErrors[],
+                                                const unsigned int sizeAngleArray,
+                                                float cubicCoefficients[],
+                                                const unsigned int lookupTableSize,
+                                                float zeroDegreeOffset)
+{
+    unsigned int i;
+    unsigned int lookupTableIndex;
+    float angleInDegree;
+    float position;
+    float t;
+    float angleError;
+    float correctedAngle;
+    float *c;
+    //same arithmetic as interpolateAngleFromCubicCoefficients, with the per table constant computed once
+    //and the wrap around only done for the angles outside of [0, 360[
+    const float segmentsPerDegree = (float)lookupTableSize/360.0f;
+    for (i=0; i<sizeAngleArray; ++i)
+    {
+        angleInDegree = anglesToInterpolateInDegree[i];
+        position = ((angleInDegree >= 0.0f && angleInDegree < 360.0f) ? angleInDegree : modulo(angleInDegree, 360.0))*segmentsPerDegree;
+        lookupTableIndex = (unsigned int)position;
+        t = position-(float)lookupTableIndex;
+        //the rounding of the product can reach the end of the table
+        if (lookupTableIndex >= lookupTableSize)
+        {
+            lookupTableIndex -= lookupTableSize;
+        }
+        c = &cubicCoefficients[4*lookupTableIndex];
+        angleError = ((c[3]*t+c[2])*t+c[1])*t+c[0];
+        angleErrors[i] = angleError;
+        correctedAngle = (angleInDegree-angleError)+zeroDegreeOffset;
+        correctedAnglesInDegree[i] = (correctedAngle >= 0.0f && correctedAngle < 360.0f) ? correctedAngle : modulo(correctedAngle, 360.0);
+    }
+}
+
 float mu(float x1, float x2, float measuredAngleInDegree)
 {
    return (measuredAngleInDegree-x1)/(modulo(x2-x1,360.0));
@@ -98,6 +98,51 @@ float interpolateAngleFromFittedCurve(  float angleToInterpolateInDegree,
                                         float zeroDegreeOffset,
                                         float *pAngleError);
 
+/**
+ * @brief Compute the interpolated angle using the cubic Hermite
+ * polynomial coefficients lookup table.
+ *
+ * The lookup table angles must be evenly spaced, starting at 0 degree
+ * (i*360/@p lookupTableSize). The input angle wraps around at 360 degree.
+ * The polynomial of the segment is evaluated with Horner's scheme.
+ *
+ * @param angleToInterpolateInDegree Angle input
+ * @param cubicCoefficients Lookup table with the c0, c1, c2, c3 coefficients of every segment
+ * @param lookupTableSize Size of the lookup table (number of segments)
+ * @param zeroDegreeOffset Angle offset at 0 degree
+ * @param pAngleError Angle Error
+ * @return corrected angle
+ */
+float interpolateAngleFromCubicCoefficients(   float angleToInterpolateInDegree,
+                                                float cubicCoefficients[],
+                                                const unsigned int lookupTableSize,
+                                                float zeroDegreeOffset,
+                                                float *pAngleError);
+
+/**
+ * @brief Compute the interpolated angles of a whole array using the cubic
+ * Hermite polynomial coefficients lookup table.
+ *
+ * Batch version of #interpolateAngleFromCubicCoefficients, with the same
+ * results. The segment scale is computed once per call and the wrap around
+ * is only computed for the angles outside of [0, 360[.
+ *
+ * @param anglesToInterpolateInDegree Angles input
+ * @param correctedAnglesInDegree Corrected angles output
+ * @param angleErrors Angle errors output
+ * @param sizeAngleArray Size of the input and output arrays
+ * @param cubicCoefficients Lookup table with the c0, c1, c2, c3 coefficients of every segment
+ * @param lookupTableSize Size of the lookup table (number of segments)
+ * @param zeroDegreeOffset Angle offset at 0 degree
+ */
+void interpolateAngleArrayFromCubicCoefficients(float anglesToInterpolateInDegree[],
+                                                float correctedAnglesInDegree[],
+                                                float angleErrors[],
+                                                const unsigned int sizeAngleArray,
+                                                float cubicCoefficients[],
+                                                const unsigned int lookupTableSize,
+                                                float zeroDegreeOffset);
+
 /**
  * @brief Compute where to estimate the value on the interpolated line.
  *
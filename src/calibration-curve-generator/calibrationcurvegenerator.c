@@ -7,31 +7,249 @@ static float modulo(float x, float y)
     return b < 0 ? b + y : b;
 }
 
-static void getHarmonics(float angleErrorArrayInDegree[],
-                           const unsigned int sizeAngleArray,
-                           unsigned int harmonicOrder,
-                           float *pHarmonicAmplitude,
-                           float *pHarmonicPhase)
+/**
+ * Running sums of the single pass harmonic extraction. The sums are kept for
+ * both candidate angle errors, the plain one and the one shifted by 180 degree
+ * used when the error wraps around 0/360 degree, so the choice can be made
+ * once all the samples have been seen. The mean is subtracted at the end with
+ * sum((e-mean)*cos) = sum(e*cos)-mean*sum(cos).
+ */
+typedef struct AngleErrorAccumulator
+{
+    double sumAngleError;                                   /**< sum(e) */
+    unsigned int upperHalfNumber;                           /**< Number of e >= 180 degree. */
+    unsigned int jumpNumber;                                /**< Number of jumps above 180 degree between consecutive samples. */
+    float firstAngleError;
+    float previousAngleError;
+    double sumCos[CALIBRATION_HARMONIC_NUMBER];             /**< sum(e*cos(k*theta)) */
+    double sumSin[CALIBRATION_HARMONIC_NUMBER];             /**< sum(e*sin(k*theta)) */
+    double sumTrigCos[CALIBRATION_HARMONIC_NUMBER];         /**< sum(cos(k*theta)) */
+    double sumTrigSin[CALIBRATION_HARMONIC_NUMBER];         /**< sum(sin(k*theta)) */
+    double sumUpperHalfCos[CALIBRATION_HARMONIC_NUMBER];    /**< sum(cos(k*theta)) for e >= 180 degree */
+    double sumUpperHalfSin[CALIBRATION_HARMONIC_NUMBER];    /**< sum(sin(k*theta)) for e >= 180 degree */
+} AngleErrorAccumulator;
+
+static void initAngleErrorAccumulator(AngleErrorAccumulator *pAccumulator)
+{
+    unsigned int k;
+    pAccumulator->sumAngleError = 0.0;
+    pAccumulator->upperHalfNumber = 0;
+    pAccumulator->jumpNumber = 0;
+    pAccumulator->firstAngleError = 0.0;
+    pAccumulator->previousAngleError = 0.0;
+    for (k=0; k<CALIBRATION_HARMONIC_NUMBER; ++k)
+    {
+        pAccumulator->sumCos[k] = 0.0;
+        pAccumulator->sumSin[k] = 0.0;
+        pAccumulator->sumTrigCos[k] = 0.0;
+        pAccumulator->sumTrigSin[k] = 0.0;
+        pAccumulator->sumUpperHalfCos[k] = 0.0;
+        pAccumulator->sumUpperHalfSin[k] = 0.0;
+    }
+}
+
+//angle error in [0, 360[ without fmodf for the usual inputs in [0, 360[
+static float wrapAngleError(float angleError)
+{
+    if (angleError < 0.0)
+    {
+        angleError += 360.0;
+    }
+    if (angleError < 0.0 || angleError >= 360.0)
+    {
+        angleError = modulo(angleError, 360.0);
+    }
+    return angleError;
+}
+
+//same as modulo(angleError+180.0, 360.0) for an angle error in [0, 360[
+static float shiftAngleError(float angleError)
+{
+    return (angleError < 180.0) ? angleError+180.0 : angleError-180.0;
+}
+
+static void accumulateAngleError(AngleErrorAccumulator *pAccumulator,
+                                 float angleError,
+                                 unsigned int index,
+                                 const unsigned int sizeAngleArray)
+{
+    unsigned int k;
+    const float angleRadian = (float)((double)index*2.0*M_PI/(double)sizeAngleArray);
+    const unsigned char upperHalf = (angleError >= 180.0);
+    float cosHarmonic[CALIBRATION_HARMONIC_NUMBER];
+    float sinHarmonic[CALIBRATION_HARMONIC_NUMBER];
+    //only the first harmonic calls the trigonometric functions, the other ones use the angle addition formulas
+    cosHarmonic[0] = cosf(angleRadian);
+    sinHarmonic[0] = sinf(angleRadian);
+    for (k=1; k<CALIBRATION_HARMONIC_NUMBER; ++k)
+    {
+        cosHarmonic[k] = cosHarmonic[k-1]*cosHarmonic[0]-sinHarmonic[k-1]*sinHarmonic[0];
+        sinHarmonic[k] = sinHarmonic[k-1]*cosHarmonic[0]+cosHarmonic[k-1]*sinHarmonic[0];
+    }
+    if (index == 0)
+    {
+        pAccumulator->firstAngleError = angleError;
+    }
+    else if (fabsf(angleError-pAccumulator->previousAngleError) > 180.0)
+    {
+        pAccumulator->jumpNumber++;
+    }
+    pAccumulator->previousAngleError = angleError;
+    pAccumulator->sumAngleError += angleError;
+    pAccumulator->upperHalfNumber += upperHalf;
+    for (k=0; k<CALIBRATION_HARMONIC_NUMBER; ++k)
+    {
+        pAccumulator->sumCos[k] += (double)angleError*cosHarmonic[k];
+        pAccumulator->sumSin[k] += (double)angleError*sinHarmonic[k];
+        pAccumulator->sumTrigCos[k] += cosHarmonic[k];
+        pAccumulator->sumTrigSin[k] += sinHarmonic[k];
+        if (upperHalf)
+        {
+            pAccumulator->sumUpperHalfCos[k] += cosHarmonic[k];
+            pAccumulator->sumUpperHalfSin[k] += sinHarmonic[k];
+        }
+    }
+}
+
+//pick the plain or the shifted angle error, compute the harmonics from the running sums and return the mean angle error
+static float getAccumulatedHarmonics(AngleErrorAccumulator *pAccumulator,
+                                     const unsigned int sizeAngleArray,
+                                     unsigned char *pShifted,
+                                     float *pH[CALIBRATION_HARMONIC_NUMBER],
+                                     float *pPhi[CALIBRATION_HARMONIC_NUMBER])
+{
+    unsigned int k;
+    double sumAngleError = pAccumulator->sumAngleError;
+    double meanAngleError;
+    double sumCos;
+    double sumSin;
+    double x;
+    double y;
+    //the wrap from the last sample to the first one counts as well
+    if (sizeAngleArray > 1 && fabsf(pAccumulator->firstAngleError-pAccumulator->previousAngleError) > 180.0)
+    {
+        pAccumulator->jumpNumber++;
+    }
+    //if jumps detected add 180 degree: e+180 for e < 180, e-180 otherwise
+    *pShifted = (pAccumulator->jumpNumber > 0);
+    if (*pShifted)
+    {
+        sumAngleError += 180.0*(double)sizeAngleArray-360.0*(double)pAccumulator->upperHalfNumber;
+    }
+    meanAngleError = sumAngleError/(double)sizeAngleArray;
+    for (k=0; k<CALIBRATION_HARMONIC_NUMBER; ++k)
+    {
+        sumCos = pAccumulator->sumCos[k];
+        sumSin = pAccumulator->sumSin[k];
+        if (*pShifted)
+        {
+            sumCos += 180.0*pAccumulator->sumTrigCos[k]-360.0*pAccumulator->sumUpperHalfCos[k];
+            sumSin += 180.0*pAccumulator->sumTrigSin[k]-360.0*pAccumulator->sumUpperHalfSin[k];
+        }
+        //substract the mean error value to center the curve around zero
+        x = (2.0/(double)sizeAngleArray)*(sumCos-meanAngleError*pAccumulator->sumTrigCos[k]);
+        y = (2.0/(double)sizeAngleArray)*(sumSin-meanAngleError*pAccumulator->sumTrigSin[k]);
+        *pH[k] = (float)sqrt(x*x+y*y);
+        *pPhi[k] = (float)atan2(y, x);
+    }
+    return (float)meanAngleError;
+}
+
+//rewrite the angle error stored during the pass as the centered error used for the harmonics
+static void centerAngleErrorArray(float angleErrorArrayInDegree[],
+                                  const unsigned int sizeAngleArray,
+                                  unsigned char shifted,
+                                  float meanAngleError)
 {
-    float period = (float)sizeAngleArray/(float)harmonicOrder;
     unsigned int i;
-    float cosHarmonic;
-    float sinHarmonic;
-    float x;
-    float y;
-    float sumCosHarmonic = 0.0;
-    float sumSinHarmonic = 0.0;
     for (i=0; i<sizeAngleArray; ++i)
     {
-        cosHarmonic = cosf((float)i*2.0*M_PI/period);
-        sinHarmonic = sinf((float)i*2.0*M_PI/period);
-        sumCosHarmonic += angleErrorArrayInDegree[i]*cosHarmonic;
-        sumSinHarmonic += angleErrorArrayInDegree[i]*sinHarmonic;
+        if (shifted)
+        {
+            angleErrorArrayInDegree[i] = shiftAngleError(angleErrorArrayInDegree[i]);
+        }
+        angleErrorArrayInDegree[i] -= meanAngleError;
+    }
+}
+
+static unsigned char checkHarmonicsPointers(float *pH1,
+                                            float *pH2,
+                                            float *pH3,
+                                            float *pH4,
+                                            float *pPhi1,
+                                            float *pPhi2,
+                                            float *pPhi3,
+                                            float *pPhi4)
+{
+    if (pH1 == 0 || pH2 == 0 || pH3 == 0 || pH4 == 0 ||
+        pPhi1 == 0 || pPhi2 == 0 || pPhi3 == 0 || pPhi4 == 0)
+    {
+        return CALIBRATION_ERROR_NULL_POINTER;
     }
-    x = (2.0/(float)sizeAngleArray)*sumCosHarmonic;
-    y = (2.0/(float)sizeAngleArray)*sumSinHarmonic;
-    *pHarmonicAmplitude = sqrtf(powf(x,2.0)+powf(y,2.0));
-    *pHarmonicPhase =atan2f(y, x);
+    return CALIBRATION_SUCCESS;
+}
+
+static float getFittedAngleError(float angleInDegree,
+                                 float *pH1,
+                                 float *pH2,
+                                 float *pH3,
+                                 float *pH4,
+                                 float *pPhi1,
+                                 float *pPhi2,
+                                 float *pPhi3,
+                                 float *pPhi4)
+{
+    float angleRadian = angleInDegree*M_PI/180.0;
+    return  (*pH1)*cosf((1.0*angleRadian-(*pPhi1)))+
+            (*pH2)*cosf((2.0*angleRadian-(*pPhi2)))+
+            (*pH3)*cosf((3.0*angleRadian-(*pPhi3)))+
+            (*pH4)*cosf((4.0*angleRadian-(*pPhi4)));
+}
+
+static float getFittedAngleErrorSlope(float angleInDegree,
+                                      float *pH1,
+                                      float *pH2,
+                                      float *pH3,
+                                      float *pH4,
+                                      float *pPhi1,
+                                      float *pPhi2,
+                                      float *pPhi3,
+                                      float *pPhi4)
+{
+    float angleRadian = angleInDegree*M_PI/180.0;
+    //derivative of the fitted curve, in degree of error per degree of angle
+    return -(M_PI/180.0)*(  1.0*(*pH1)*sinf((1.0*angleRadian-(*pPhi1)))+
+                            2.0*(*pH2)*sinf((2.0*angleRadian-(*pPhi2)))+
+                            3.0*(*pH3)*sinf((3.0*angleRadian-(*pPhi3)))+
+                            4.0*(*pH4)*sinf((4.0*angleRadian-(*pPhi4))));
+}
+
+//linear segment between two nodes, written as constant + slope*angle
+static void getConstantAndSlope(float angleInDegree,
+                                float nextAngleInDegree,
+                                float fittedAngleError,
+                                float nextFittedAngleError,
+                                float *pConstant,
+                                float *pSlope)
+{
+    *pSlope=(nextFittedAngleError-fittedAngleError)/(nextAngleInDegree-angleInDegree);
+    *pConstant=fittedAngleError-((*pSlope)*angleInDegree);
+}
+
+//cubic Hermite segment, the tangents are scaled to the segment and the local parameter goes from 0 to 1
+static void getCubicCoefficients(float y1,
+                                 float y2,
+                                 float slope1,
+                                 float slope2,
+                                 float segmentWidth,
+                                 float cubicCoefficients[])
+{
+    float m1 = slope1*segmentWidth;
+    float m2 = slope2*segmentWidth;
+    cubicCoefficients[0]=y1;
+    cubicCoefficients[1]=m1;
+    cubicCoefficients[2]=3.0*(y2-y1)-2.0*m1-m2;
+    cubicCoefficients[3]=2.0*(y1-y2)+m1+m2;
 }
 
 unsigned char extractAngleErrorHarmonics(   float referenceAngleInDegree[],
@@ -48,53 +266,100 @@ unsigned char extractAngleErrorHarmonics(   float referenceAngleInDegree[],
                                             float *pPhi4)
 {
     unsigned int i;
-    float meanAngleError = 0;
-    unsigned int jumpNumber = 0;
-    for(i=0;i<sizeAngleArray;++i)
+    float angleError;
+    float meanAngleError;
+    unsigned char shifted;
+    AngleErrorAccumulator accumulator;
+    float *pH[CALIBRATION_HARMONIC_NUMBER] = {pH1, pH2, pH3, pH4};
+    float *pPhi[CALIBRATION_HARMONIC_NUMBER] = {pPhi1, pPhi2, pPhi3, pPhi4};
+    if (referenceAngleInDegree == 0 || measuredAngleInDegree == 0 ||
+        checkHarmonicsPointers(pH1, pH2, pH3, pH4, pPhi1, pPhi2, pPhi3, pPhi4) != CALIBRATION_SUCCESS)
     {
-        angleErrorArrayInDegree[i]=modulo(measuredAngleInDegree[i]-referenceAngleInDegree[i], 360.0);
-        meanAngleError+=angleErrorArrayInDegree[i];
+        return CALIBRATION_ERROR_NULL_POINTER;
     }
-    //Check for angle error jumps
+    if (sizeAngleArray == 0)
+    {
+        return CALIBRATION_ERROR_INVALID_SIZE;
+    }
+    initAngleErrorAccumulator(&accumulator);
     for(i=0;i<sizeAngleArray;++i)
     {
-        if (i == 0)
+        angleError = wrapAngleError(measuredAngleInDegree[i]-referenceAngleInDegree[i]);
+        if (angleErrorArrayInDegree != 0)
         {
-            if (fabsf(angleErrorArrayInDegree[0]-angleErrorArrayInDegree[sizeAngleArray-1]) > 180.0)
-            {
-                jumpNumber++;
-            }
-        }
-        else
-        {
-            if (fabsf(angleErrorArrayInDegree[i]-angleErrorArrayInDegree[i-1]) > 180.0)
-            {
-                jumpNumber++;
-            }
+            angleErrorArrayInDegree[i] = angleError;
         }
+        accumulateAngleError(&accumulator, angleError, i, sizeAngleArray);
+    }
+    meanAngleError = getAccumulatedHarmonics(&accumulator, sizeAngleArray, &shifted, pH, pPhi);
+    if (angleErrorArrayInDegree != 0)
+    {
+        centerAngleErrorArray(angleErrorArrayInDegree, sizeAngleArray, shifted, meanAngleError);
+    }
+    return CALIBRATION_SUCCESS;
+}
+
+unsigned char extractAngleErrorHarmonicsFromRawData(const unsigned short rawAnglePairs[],
+                                                    const unsigned int fullScaleValue,
+                                                    float angleErrorArrayInDegree[],
+                                                    const unsigned int sizeAngleArray,
+                                                    float *pH1,
+                                                    float *pH2,
+                                                    float *pH3,
+                                                    float *pH4,
+                                                    float *pPhi1,
+                                                    float *pPhi2,
+                                                    float *pPhi3,
+                                                    float *pPhi4)
+{
+    unsigned int i;
+    const unsigned short *pRawAnglePair = rawAnglePairs;
+    int rawAngleError;
+    float angleError;
+    float meanAngleError;
+    float rawToDegree;
+    unsigned char shifted;
+    AngleErrorAccumulator accumulator;
+    float *pH[CALIBRATION_HARMONIC_NUMBER] = {pH1, pH2, pH3, pH4};
+    float *pPhi[CALIBRATION_HARMONIC_NUMBER] = {pPhi1, pPhi2, pPhi3, pPhi4};
+    if (rawAnglePairs == 0 ||
+        checkHarmonicsPointers(pH1, pH2, pH3, pH4, pPhi1, pPhi2, pPhi3, pPhi4) != CALIBRATION_SUCCESS)
+    {
+        return CALIBRATION_ERROR_NULL_POINTER;
+    }
+    if (sizeAngleArray == 0)
+    {
+        return CALIBRATION_ERROR_INVALID_SIZE;
     }
-    //If jumps detected add 180 degree
-    if (jumpNumber>0)
+    if (fullScaleValue == 0 || fullScaleValue > 65536)
     {
-        meanAngleError = 0;
-        for(i=0;i<sizeAngleArray;++i)
+        return CALIBRATION_ERROR_INVALID_PARAMETER;
+    }
+    rawToDegree = 360.0/(float)fullScaleValue;
+    initAngleErrorAccumulator(&accumulator);
+    //the modulo and the conversion in degree are done on the raw codes
+    //the pairs are walked with a pointer, 2*i would wrap above 2^31 samples
+    for(i=0;i<sizeAngleArray;++i, pRawAnglePair+=2)
+    {
+        if (pRawAnglePair[0] >= fullScaleValue || pRawAnglePair[1] >= fullScaleValue)
+        {
+            return CALIBRATION_ERROR_INVALID_PARAMETER;
+        }
+        rawAngleError = (int)pRawAnglePair[1]-(int)pRawAnglePair[0];
+        rawAngleError += (rawAngleError < 0) ? (int)fullScaleValue : 0;
+        angleError = (float)rawAngleError*rawToDegree;
+        if (angleErrorArrayInDegree != 0)
         {
-            angleErrorArrayInDegree[i]=modulo(angleErrorArrayInDegree[i]+180.0, 360.0);
-            meanAngleError+=angleErrorArrayInDegree[i];
+            angleErrorArrayInDegree[i] = angleError;
         }
+        accumulateAngleError(&accumulator, angleError, i, sizeAngleArray);
     }
-    //substract the mean error value to center the curve around zero
-    meanAngleError/=(float)sizeAngleArray;
-    for  (i=0;i<sizeAngleArray;++i)
+    meanAngleError = getAccumulatedHarmonics(&accumulator, sizeAngleArray, &shifted, pH, pPhi);
+    if (angleErrorArrayInDegree != 0)
     {
-        angleErrorArrayInDegree[i]-=meanAngleError;
+        centerAngleErrorArray(angleErrorArrayInDegree, sizeAngleArray, shifted, meanAngleError);
     }
-    //get harmonics components
-    getHarmonics(angleErrorArrayInDegree, sizeAngleArray, 1, pH1, pPhi1);
-    getHarmonics(angleErrorArrayInDegree, sizeAngleArray, 2, pH2, pPhi2);
-    getHarmonics(angleErrorArrayInDegree, sizeAngleArray, 3, pH3, pPhi3);
-    getHarmonics(angleErrorArrayInDegree, sizeAngleArray, 4, pH4, pPhi4);
-    return 0;
+    return CALIBRATION_SUCCESS;
 }
 
 unsigned char generateAngleErrorLookupTableUsingFittedCurve(float angleInDegree[],
@@ -110,16 +375,16 @@ unsigned char generateAngleErrorLookupTableUsingFittedCurve(float angleInDegree[
                                                             float *pPhi4)
 {
     unsigned int i;
-    float angleRadian;
+    if (angleInDegree == 0 || fittedAngleErrorInDegree == 0 ||
+        checkHarmonicsPointers(pH1, pH2, pH3, pH4, pPhi1, pPhi2, pPhi3, pPhi4) != CALIBRATION_SUCCESS)
+    {
+        return CALIBRATION_ERROR_NULL_POINTER;
+    }
     for  (i=0; i < sizeAngleArray; ++i)
     {
-        angleRadian = angleInDegree[i]*M_PI/180.0;
-        fittedAngleErrorInDegree[i]=   (*pH1)*cosf((1.0*angleRadian-(*pPhi1)))+
-                                        (*pH2)*cosf((2.0*angleRadian-(*pPhi2)))+
-                                        (*pH3)*cosf((3.0*angleRadian-(*pPhi3)))+
-                                        (*pH4)*cosf((4.0*angleRadian-(*pPhi4)));
+        fittedAngleErrorInDegree[i]=getFittedAngleError(angleInDegree[i], pH1, pH2, pH3, pH4, pPhi1, pPhi2, pPhi3, pPhi4);
     }
-    return 0;
+    return CALIBRATION_SUCCESS;
 }
 
 unsigned char generateAngleErrorLookupTableUsingConstantsAndSlopes( float angleInDegree[],
@@ -136,29 +401,357 @@ unsigned char generateAngleErrorLookupTableUsingConstantsAndSlopes( float angleI
                                                                     float *pPhi4)
 {
     unsigned int i;
-    float angleRadian;
-    float fittedAngleErrorInDegree[sizeAngleArray];
-    float shiftedAngleInDegree[sizeAngleArray];
-    float shiftedfittedAngleErrorInDegree[sizeAngleArray];
+    float firstFittedAngleError;
+    float nextFittedAngleError;
+    float nextAngleInDegree;
+    if (angleInDegree == 0 || angleErrorConstants == 0 || angleErrorSlopes == 0 ||
+        checkHarmonicsPointers(pH1, pH2, pH3, pH4, pPhi1, pPhi2, pPhi3, pPhi4) != CALIBRATION_SUCCESS)
+    {
+        return CALIBRATION_ERROR_NULL_POINTER;
+    }
+    if (sizeAngleArray < 2)
+    {
+        return CALIBRATION_ERROR_INVALID_SIZE;
+    }
+    //the fitted curve is stored in the constants array until the slopes are known
     for  (i=0; i < sizeAngleArray; ++i)
     {
-        angleRadian = angleInDegree[i]*M_PI/180.0;
-        fittedAngleErrorInDegree[i]=   (*pH1)*cosf((1.0*angleRadian-(*pPhi1)))+
-                                        (*pH2)*cosf((2.0*angleRadian-(*pPhi2)))+
-                                        (*pH3)*cosf((3.0*angleRadian-(*pPhi3)))+
-                                        (*pH4)*cosf((4.0*angleRadian-(*pPhi4)));
+        angleErrorConstants[i]=getFittedAngleError(angleInDegree[i], pH1, pH2, pH3, pH4, pPhi1, pPhi2, pPhi3, pPhi4);
     }
-    for  (i=0; i < (sizeAngleArray-1); ++i)
+    firstFittedAngleError=angleErrorConstants[0];
+    for  (i=0; i < sizeAngleArray; ++i)
+    {
+        nextAngleInDegree=(i < (sizeAngleArray-1)) ? angleInDegree[i+1] : angleInDegree[0];
+        nextFittedAngleError=(i < (sizeAngleArray-1)) ? angleErrorConstants[i+1] : firstFittedAngleError;
+        getConstantAndSlope(angleInDegree[i], nextAngleInDegree, angleErrorConstants[i], nextFittedAngleError,
+                            &angleErrorConstants[i], &angleErrorSlopes[i]);
+    }
+    return CALIBRATION_SUCCESS;
+}
+
+unsigned char generateAngleErrorLookupTableUsingCubicCoefficients(float angleInDegree[],
+                                                                  float cubicCoefficients[],
+                                                                  const unsigned int sizeAngleArray,
+                                                                  float *pH1,
+                                                                  float *pH2,
+                                                                  float *pH3,
+                                                                  float *pH4,
+                                                                  float *pPhi1,
+                                                                  float *pPhi2,
+                                                                  float *pPhi3,
+                                                                  float *pPhi4)
+{
+    unsigned int i;
+    unsigned int nPlus1Index;
+    float segmentWidth;
+    if (angleInDegree == 0 || cubicCoefficients == 0 ||
+        checkHarmonicsPointers(pH1, pH2, pH3, pH4, pPhi1, pPhi2, pPhi3, pPhi4) != CALIBRATION_SUCCESS)
     {
-        shiftedAngleInDegree[i]=angleInDegree[i+1];
-        shiftedfittedAngleErrorInDegree[i]=fittedAngleErrorInDegree[i+1];
+        return CALIBRATION_ERROR_NULL_POINTER;
     }
-    shiftedAngleInDegree[sizeAngleArray-1]=angleInDegree[0];
-    shiftedfittedAngleErrorInDegree[sizeAngleArray-1]=fittedAngleErrorInDegree[0];
     for  (i=0; i < sizeAngleArray; ++i)
     {
-        angleErrorSlopes[i]=(shiftedfittedAngleErrorInDegree[i]-fittedAngleErrorInDegree[i])/(shiftedAngleInDegree[i]-angleInDegree[i]);
-        angleErrorConstants[i]=fittedAngleErrorInDegree[i]-(angleErrorSlopes[i]*angleInDegree[i]);
+        nPlus1Index = (i+1)%sizeAngleArray;
+        segmentWidth = modulo(angleInDegree[nPlus1Index]-angleInDegree[i], 360.0);
+        if (segmentWidth == 0.0)
+        {
+            segmentWidth = 360.0;
+        }
+        getCubicCoefficients(getFittedAngleError(angleInDegree[i], pH1, pH2, pH3, pH4, pPhi1, pPhi2, pPhi3, pPhi4),
+                             getFittedAngleError(angleInDegree[nPlus1Index], pH1, pH2, pH3, pH4, pPhi1, pPhi2, pPhi3, pPhi4),
+                             getFittedAngleErrorSlope(angleInDegree[i], pH1, pH2, pH3, pH4, pPhi1, pPhi2, pPhi3, pPhi4),
+                             getFittedAngleErrorSlope(angleInDegree[nPlus1Index], pH1, pH2, pH3, pH4, pPhi1, pPhi2, pPhi3, pPhi4),
+                             segmentWidth,
+                             &cubicCoefficients[4*i]);
+    }
+    return CALIBRATION_SUCCESS;
+}
+
+unsigned char generateMultiResolutionAngleErrorLookupTables(float denseAngleErrorInDegree[],
+                                                            float denseAngleErrorSlopes[],
+                                                            const unsigned int denseSize,
+                                                            const unsigned int lookupTableSizes[],
+                                                            float maxInterpolationErrorInDegree[],
+                                                            const unsigned int lookupTableNumber,
+                                                            float *pH1,
+                                                            float *pH2,
+                                                            float *pH3,
+                                                            float *pH4,
+                                                            float *pPhi1,
+                                                            float *pPhi2,
+                                                            float *pPhi3,
+                                                            float *pPhi4)
+{
+    unsigned int i;
+    unsigned int j;
+    unsigned int stride;
+    unsigned int nodeIndex;
+    float y1;
+    float y2;
+    float muValue;
+    float interpolationError;
+    if (denseAngleErrorInDegree == 0 || lookupTableSizes == 0 || maxInterpolationErrorInDegree == 0 ||
+        checkHarmonicsPointers(pH1, pH2, pH3, pH4, pPhi1, pPhi2, pPhi3, pPhi4) != CALIBRATION_SUCCESS)
+    {
+        return CALIBRATION_ERROR_NULL_POINTER;
+    }
+    for (j=0; j < lookupTableNumber; ++j)
+    {
+        if (lookupTableSizes[j] == 0 || lookupTableSizes[j] > denseSize || (denseSize % lookupTableSizes[j]) != 0)
+        {
+            return CALIBRATION_ERROR_INVALID_SIZE;
+        }
+    }
+    //evaluate the model only once, on the dense grid
+    for (i=0; i < denseSize; ++i)
+    {
+        denseAngleErrorInDegree[i]=getFittedAngleError((float)i*360.0/(float)denseSize, pH1, pH2, pH3, pH4, pPhi1, pPhi2, pPhi3, pPhi4);
+        if (denseAngleErrorSlopes != 0)
+        {
+            denseAngleErrorSlopes[i]=getFittedAngleErrorSlope((float)i*360.0/(float)denseSize, pH1, pH2, pH3, pH4, pPhi1, pPhi2, pPhi3, pPhi4);
+        }
+    }
+    //the nodes of every lookup table are a subset of the dense grid
+    for (j=0; j < lookupTableNumber; ++j)
+    {
+        stride = denseSize/lookupTableSizes[j];
+        maxInterpolationErrorInDegree[j] = 0.0;
+        for (i=0; i < denseSize; ++i)
+        {
+            nodeIndex = i-(i%stride);
+            y1 = denseAngleErrorInDegree[nodeIndex];
+            y2 = denseAngleErrorInDegree[(nodeIndex+stride)%denseSize];
+            muValue = (float)(i-nodeIndex)/(float)stride;
+            interpolationError = fabsf(y1*(1-muValue)+y2*muValue-denseAngleErrorInDegree[i]);
+            if (interpolationError > maxInterpolationErrorInDegree[j])
+            {
+                maxInterpolationErrorInDegree[j] = interpolationError;
+            }
+        }
+    }
+    return CALIBRATION_SUCCESS;
+}
+
+unsigned char extractLookupTableFromDenseCurve( float denseAngleErrorInDegree[],
+                                                const unsigned int denseSize,
+                                                float angleErrorInDegree[],
+                                                const unsigned int lookupTableSize)
+{
+    unsigned int i;
+    unsigned int stride;
+    if (denseAngleErrorInDegree == 0 || angleErrorInDegree == 0)
+    {
+        return CALIBRATION_ERROR_NULL_POINTER;
+    }
+    if (lookupTableSize == 0 || lookupTableSize > denseSize || (denseSize % lookupTableSize) != 0)
+    {
+        return CALIBRATION_ERROR_INVALID_SIZE;
+    }
+    stride = denseSize/lookupTableSize;
+    for (i=0; i < lookupTableSize; ++i)
+    {
+        angleErrorInDegree[i]=denseAngleErrorInDegree[i*stride];
+    }
+    return CALIBRATION_SUCCESS;
+}
+
+unsigned char extractConstantsAndSlopesFromDenseCurve(  float denseAngleErrorInDegree[],
+                                                        const unsigned int denseSize,
+                                                        float angleErrorConstants[],
+                                                        float angleErrorSlopes[],
+                                                        const unsigned int lookupTableSize)
+{
+    unsigned int i;
+    unsigned int stride;
+    float nodeAngleInDegree;
+    float nextNodeAngleInDegree;
+    if (denseAngleErrorInDegree == 0 || angleErrorConstants == 0 || angleErrorSlopes == 0)
+    {
+        return CALIBRATION_ERROR_NULL_POINTER;
+    }
+    if (lookupTableSize < 2 || lookupTableSize > denseSize || (denseSize % lookupTableSize) != 0)
+    {
+        return CALIBRATION_ERROR_INVALID_SIZE;
+    }
+    stride = denseSize/lookupTableSize;
+    for (i=0; i < lookupTableSize; ++i)
+    {
+        //same nodes as generateAngleErrorLookupTableUsingConstantsAndSlopes, the last segment goes back to angle 0
+        nodeAngleInDegree = (float)i*360.0/(float)lookupTableSize;
+        nextNodeAngleInDegree = (i < (lookupTableSize-1)) ? (float)(i+1)*360.0/(float)lookupTableSize : 0.0;
+        getConstantAndSlope(nodeAngleInDegree, nextNodeAngleInDegree,
+                            denseAngleErrorInDegree[i*stride], denseAngleErrorInDegree[((i+1)%lookupTableSize)*stride],
+                            &angleErrorConstants[i], &angleErrorSlopes[i]);
+    }
+    return CALIBRATION_SUCCESS;
+}
+
+unsigned char extractCubicCoefficientsFromDenseCurve(   float denseAngleErrorInDegree[],
+                                                        float denseAngleErrorSlopes[],
+                                                        const unsigned int denseSize,
+                                                        float cubicCoefficients[],
+                                                        const unsigned int lookupTableSize)
+{
+    unsigned int i;
+    unsigned int stride;
+    unsigned int nextNodeIndex;
+    if (denseAngleErrorInDegree == 0 || denseAngleErrorSlopes == 0 || cubicCoefficients == 0)
+    {
+        return CALIBRATION_ERROR_NULL_POINTER;
+    }
+    if (lookupTableSize == 0 || lookupTableSize > denseSize || (denseSize % lookupTableSize) != 0)
+    {
+        return CALIBRATION_ERROR_INVALID_SIZE;
+    }
+    stride = denseSize/lookupTableSize;
+    for (i=0; i < lookupTableSize; ++i)
+    {
+        nextNodeIndex = ((i+1)%lookupTableSize)*stride;
+        getCubicCoefficients(denseAngleErrorInDegree[i*stride], denseAngleErrorInDegree[nextNodeIndex],
+                             denseAngleErrorSlopes[i*stride], denseAngleErrorSlopes[nextNodeIndex],
+                             360.0/(float)lookupTableSize,
+                             &cubicCoefficients[4*i]);
+    }
+    return CALIBRATION_SUCCESS;
+}
+
+unsigned char calibrationContextInit(   magalpha_calib_ctx *pContext,
+                                        float scratchBuffer[],
+                                        const unsigned int scratchSize)
+{
+    unsigned int i;
+    if (pContext == 0 || scratchBuffer == 0)
+    {
+        return CALIBRATION_ERROR_NULL_POINTER;
+    }
+    if (scratchSize == 0)
+    {
+        return CALIBRATION_ERROR_INVALID_SIZE;
+    }
+    pContext->scratchBuffer = scratchBuffer;
+    pContext->scratchSize = scratchSize;
+    pContext->dataLength = 0;
+    for (i=0; i<CALIBRATION_HARMONIC_NUMBER; ++i)
+    {
+        pContext->h[i] = 0.0;
+        pContext->phi[i] = 0.0;
+    }
+    return CALIBRATION_SUCCESS;
+}
+
+unsigned char calibrationContextCompute(magalpha_calib_ctx *pContext,
+                                        float referenceAngleInDegree[],
+                                        float measuredAngleInDegree[],
+                                        const unsigned int sizeAngleArray)
+{
+    unsigned char status;
+    if (pContext == 0 || pContext->scratchBuffer == 0)
+    {
+        return CALIBRATION_ERROR_NULL_POINTER;
+    }
+    if (sizeAngleArray > pContext->scratchSize)
+    {
+        return CALIBRATION_ERROR_BUFFER_TOO_SMALL;
+    }
+    pContext->dataLength = 0;
+    status = extractAngleErrorHarmonics(referenceAngleInDegree, measuredAngleInDegree,
+                                        pContext->scratchBuffer, sizeAngleArray,
+                                        &pContext->h[0], &pContext->h[1], &pContext->h[2], &pContext->h[3],
+                                        &pContext->phi[0], &pContext->phi[1], &pContext->phi[2], &pContext->phi[3]);
+    if (status == CALIBRATION_SUCCESS)
+    {
+        pContext->dataLength = sizeAngleArray;
+    }
+    return status;
+}
+
+unsigned char calibrationContextComputeFromRawData( magalpha_calib_ctx *pContext,
+                                                    const unsigned short rawAnglePairs[],
+                                                    const unsigned int fullScaleValue,
+                                                    const unsigned int sizeAngleArray)
+{
+    unsigned char status;
+    if (pContext == 0 || pContext->scratchBuffer == 0)
+    {
+        return CALIBRATION_ERROR_NULL_POINTER;
+    }
+    if (sizeAngleArray > pContext->scratchSize)
+    {
+        return CALIBRATION_ERROR_BUFFER_TOO_SMALL;
+    }
+    pContext->dataLength = 0;
+    status = extractAngleErrorHarmonicsFromRawData(rawAnglePairs, fullScaleValue,
+                                                   pContext->scratchBuffer, sizeAngleArray,
+                                                   &pContext->h[0], &pContext->h[1], &pContext->h[2], &pContext->h[3],
+                                                   &pContext->phi[0], &pContext->phi[1], &pContext->phi[2], &pContext->phi[3]);
+    if (status == CALIBRATION_SUCCESS)
+    {
+        pContext->dataLength = sizeAngleArray;
+    }
+    return status;
+}
+
+unsigned char calibrationContextGenerateLookupTable( magalpha_calib_ctx *pContext,
+                                                    float angleInDegree[],
+                                                    float fittedAngleErrorInDegree[],
+                                                    const unsigned int sizeAngleArray)
+{
+    if (pContext == 0)
+    {
+        return CALIBRATION_ERROR_NULL_POINTER;
+    }
+    if (pContext->dataLength == 0)
+    {
+        return CALIBRATION_ERROR_NOT_COMPUTED;
+    }
+    return generateAngleErrorLookupTableUsingFittedCurve(angleInDegree, fittedAngleErrorInDegree, sizeAngleArray,
+                                                         &pContext->h[0], &pContext->h[1], &pContext->h[2], &pContext->h[3],
+                                                         &pContext->phi[0], &pContext->phi[1], &pContext->phi[2], &pContext->phi[3]);
+}
+
+unsigned char calibrationContextGenerateConstantsAndSlopes(  magalpha_calib_ctx *pContext,
+                                                            float angleInDegree[],
+                                                            float angleErrorConstants[],
+                                                            float angleErrorSlopes[],
+                                                            const unsigned int sizeAngleArray)
+{
+    if (pContext == 0)
+    {
+        return CALIBRATION_ERROR_NULL_POINTER;
+    }
+    if (pContext->dataLength == 0)
+    {
+        return CALIBRATION_ERROR_NOT_COMPUTED;
+    }
+    return generateAngleErrorLookupTableUsingConstantsAndSlopes(angleInDegree, angleErrorConstants, angleErrorSlopes, sizeAngleArray,
+                                                                &pContext->h[0], &pContext->h[1], &pContext->h[2], &pContext->h[3],
+                                                                &pContext->phi[0], &pContext->phi[1], &pContext->phi[2], &pContext->phi[3]);
+}
+
+unsigned char calibrationContextGenerateCubicCoefficients(   magalpha_calib_ctx *pContext,
+                                                            float angleInDegree[],
+                                                            float cubicCoefficients[],
+                                                            const unsigned int sizeAngleArray)
+{
+    if (pContext == 0)
+    {
+        return CALIBRATION_ERROR_NULL_POINTER;
+    }
+    if (pContext->dataLength == 0)
+    {
+        return CALIBRATION_ERROR_NOT_COMPUTED;
+    }
+    return generateAngleErrorLookupTableUsingCubicCoefficients(angleInDegree, cubicCoefficients, sizeAngleArray,
+                                                               &pContext->h[0], &pContext->h[1], &pContext->h[2], &pContext->h[3],
+                                                               &pContext->phi[0], &pContext->phi[1], &pContext->phi[2], &pContext->phi[3]);
+}
+
+void calibrationContextDestroy(magalpha_calib_ctx *pContext)
+{
+    if (pContext != 0)
+    {
+        pContext->scratchBuffer = 0;
+        pContext->scratchSize = 0;
+        pContext->dataLength = 0;
     }
-    return 0;
 }
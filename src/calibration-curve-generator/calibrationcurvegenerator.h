@@ -38,6 +38,39 @@ extern "C" {
  * @see http://sensors.monolithicpower.com/
  */
 
+/** @brief Number of harmonics extracted from the angle error. */
+#define CALIBRATION_HARMONIC_NUMBER             4
+
+/** @brief The function succeeded. */
+#define CALIBRATION_SUCCESS                     0
+/** @brief A required pointer parameter is NULL. */
+#define CALIBRATION_ERROR_NULL_POINTER          1
+/** @brief An array size is zero or not compatible with the other sizes. */
+#define CALIBRATION_ERROR_INVALID_SIZE          2
+/** @brief A parameter is out of its valid range. */
+#define CALIBRATION_ERROR_INVALID_PARAMETER     3
+/** @brief The context scratch buffer is smaller than the input data. */
+#define CALIBRATION_ERROR_BUFFER_TOO_SMALL      4
+/** @brief The context does not contain harmonics yet. */
+#define CALIBRATION_ERROR_NOT_COMPUTED          5
+
+/**
+ * @brief Calibration context.
+ *
+ * Holds the harmonics of the last computation and a scratch buffer provided
+ * by the caller, so the same context can be reused for every recalibration
+ * without any allocation. A context must only be used by one thread at a
+ * time, several contexts can be used concurrently.
+ */
+typedef struct magalpha_calib_ctx
+{
+    float *scratchBuffer;       /**< Angle error of the last computation, owned by the caller. */
+    unsigned int scratchSize;   /**< Size of the scratch buffer. */
+    unsigned int dataLength;    /**< Number of samples of the last computation, 0 if none. */
+    float h[CALIBRATION_HARMONIC_NUMBER];   /**< Harmonic amplitudes H1 to H4. */
+    float phi[CALIBRATION_HARMONIC_NUMBER]; /**< Harmonic phases Phi1 to Phi4. */
+} magalpha_calib_ctx;
+
 
 /**
  * @brief Extract the harmonics from the measured angle values.
@@ -48,7 +81,9 @@ extern "C" {
  * The results are provided through pointer input parameters (@p pH1, @p pH2
  * @p pH3, @p pH4, @p pPhi1, @p pPhi2, @p pPhi3 and @p pPhi4). This function also
  * provide the computed angle error in degree through @p angleErrorArrayInDegree[]
- * array.
+ * array, centered around zero.
+ * The input is read in a single pass, the angle error array is optional and
+ * only written when it is not NULL.
  *
  * See below a function call example:
  * @code{.c}
@@ -82,7 +117,7 @@ extern "C" {
  * @endcode
  * @param referenceAngleInDegree[] Input array with the refereance angle set on the calibration setup.
  * @param measuredAngleInDegree[] Input array with the angle in degree measured by the sensor.
- * @param angleErrorArrayInDegree[] Output array with the computed angle error in degree.
+ * @param angleErrorArrayInDegree[] Output array with the computed angle error in degree, NULL if not needed.
  * @param sizeAngleArray size of the array provided to this function.
  * @param pH1 Pointer to H1 harmonic amplitude.
  * @param pH2 Pointer to H2 harmonic amplitude.
@@ -92,7 +127,8 @@ extern "C" {
  * @param pPhi2 Pointer to Phi2 harmonic phase.
  * @param pPhi3 Pointer to Phi3 harmonic phase.
  * @param pPhi4 Pointer to Phi4 harmonic phase.
- * @return always return 0.
+ * @return #CALIBRATION_SUCCESS, #CALIBRATION_ERROR_NULL_POINTER or
+ * #CALIBRATION_ERROR_INVALID_SIZE if @p sizeAngleArray is 0.
  */
 unsigned char extractAngleErrorHarmonics(   float referenceAngleInDegree[],
                                             float measuredAngleInDegree[],
@@ -107,6 +143,62 @@ unsigned char extractAngleErrorHarmonics(   float referenceAngleInDegree[],
                                             float *pPhi3,
                                             float *pPhi4);
 
+/**
+ * @brief Extract the harmonics from the raw sensor codes.
+ *
+ * Same as #extractAngleErrorHarmonics but the input is the packed array of
+ * raw (reference code, sensor code) pairs produced by the acquisition
+ * hardware, for example the data section of a binary capture file.
+ * The conversion from raw code to degree is done inside the angle error loop,
+ * no converted copy of the input is required.
+ *
+ * See below a function call example:
+ * @code{.c}
+ * //input parameters
+ * const unsigned int sizeAngleArray = 200;
+ * const unsigned int fullScaleValue = 65536;       //2^16 for 16 bit codes
+ * unsigned short rawAnglePairs[2*sizeAngleArray];  //fill with ref code, sensor code, ref code, ...
+ *
+ * //output parameters
+ * float angleErrorArrayInDegree[sizeAngleArray];
+ * float h1, h2, h3, h4;
+ * float phi1, phi2, phi3, phi4;
+ * extractAngleErrorHarmonicsFromRawData(rawAnglePairs, fullScaleValue,
+ *                              angleErrorArrayInDegree, sizeAngleArray,
+ *                              &h1, &h2, &h3, &h4, &phi1, &phi2, &phi3, &phi4);
+ * @endcode
+ * @param rawAnglePairs[] Input array with the interleaved reference and sensor codes (2*@p sizeAngleArray values).
+ * The codes must be smaller than @p fullScaleValue.
+ * @param fullScaleValue Number of codes per turn (for example 512 for 9 bit codes).
+ * @param angleErrorArrayInDegree[] Output array with the computed angle error in degree, NULL if not needed.
+ * @param sizeAngleArray Number of (reference, sensor) pairs provided to this function.
+ * @param pH1 Pointer to H1 harmonic amplitude.
+ * @param pH2 Pointer to H2 harmonic amplitude.
+ * @param pH3 Pointer to H3 harmonic amplitude.
+ * @param pH4 Pointer to H4 harmonic amplitude.
+ * @param pPhi1 Pointer to Phi1 harmonic phase.
+ * @param pPhi2 Pointer to Phi2 harmonic phase.
+ * @param pPhi3 Pointer to Phi3 harmonic phase.
+ * @param pPhi4 Pointer to Phi4 harmonic phase.
+ * @return #CALIBRATION_SUCCESS, #CALIBRATION_ERROR_NULL_POINTER,
+ * #CALIBRATION_ERROR_INVALID_SIZE if @p sizeAngleArray is 0 or
+ * #CALIBRATION_ERROR_INVALID_PARAMETER if @p fullScaleValue is 0 or above 65536
+ * or if a code is not smaller than @p fullScaleValue, the harmonics are then
+ * not written.
+ */
+unsigned char extractAngleErrorHarmonicsFromRawData(const unsigned short rawAnglePairs[],
+                                                    const unsigned int fullScaleValue,
+                                                    float angleErrorArrayInDegree[],
+                                                    const unsigned int sizeAngleArray,
+                                                    float *pH1,
+                                                    float *pH2,
+                                                    float *pH3,
+                                                    float *pH4,
+                                                    float *pPhi1,
+                                                    float *pPhi2,
+                                                    float *pPhi3,
+                                                    float *pPhi4);
+
 /**
  * @brief Generate the angle error lookup table using the fitted curve
  *
@@ -149,7 +241,7 @@ unsigned char extractAngleErrorHarmonics(   float referenceAngleInDegree[],
  * @param pPhi2 Pointer to Phi2 harmonic phase.
  * @param pPhi3 Pointer to Phi3 harmonic phase.
  * @param pPhi4 Pointer to Phi4 harmonic phase.
- * @return always return 0.
+ * @return #CALIBRATION_SUCCESS or #CALIBRATION_ERROR_NULL_POINTER.
  */
 unsigned char generateAngleErrorLookupTableUsingFittedCurve(float angleInDegree[],
                                                             float fittedAngleErrorInDegree[],
@@ -214,7 +306,8 @@ unsigned char generateAngleErrorLookupTableUsingFittedCurve(float angleInDegree[
  * @param pPhi2 Pointer to Phi2 harmonic phase.
  * @param pPhi3 Pointer to Phi3 harmonic phase.
  * @param pPhi4 Pointer to Phi4 harmonic phase.
- * @return always return 0.
+ * @return #CALIBRATION_SUCCESS, #CALIBRATION_ERROR_NULL_POINTER or
+ * #CALIBRATION_ERROR_INVALID_SIZE if @p sizeAngleArray is smaller than 2.
  */
 unsigned char generateAngleErrorLookupTableUsingConstantsAndSlopes( float angleInDegree[],
                                                                     float angleErrorConstants[],
@@ -229,6 +322,316 @@ unsigned char generateAngleErrorLookupTableUsingConstantsAndSlopes( float angleI
                                                                     float *pPhi3,
                                                                     float *pPhi4);
 
+/**
+ * @brief Generate the angle error lookup table using cubic Hermite
+ * polynomial coefficients
+ *
+ * Generate the calibration curve using the harmonics parameters
+ * computed with the #extractAngleErrorHarmonics.
+ * Each segment between two consecutive angles of @p angleInDegree[] (the
+ * last segment wraps around to the first angle + 360 degree) is described
+ * by the cubic Hermite polynomial which matches both the fitted curve and
+ * its analytic derivative at the two ends of the segment:
+ *
+ * angleError(t) = c0 + c1*t + c2*t^2 + c3*t^3 with t between 0 and 1 on the segment.
+ *
+ * Compared to the linear methods, the same accuracy is reached with a much
+ * smaller table. Use #interpolateAngleFromCubicCoefficients to evaluate it.
+ *
+ * See below a function call example:
+ * @code{.c}
+ * //input parameters
+ * const unsigned int lookupTableSize = 8;
+ * float angleInDegree[lookupTableSize]; //fill with i*360/lookupTableSize
+ * //from extractAngleErrorHarmonics function
+ * float h1, h2, h3, h4;
+ * float phi1, phi2, phi3, phi4;
+ * //output parameters
+ * float cubicCoefficients[4*lookupTableSize];
+ * generateAngleErrorLookupTableUsingCubicCoefficients( angleInDegree,
+ *      cubicCoefficients, lookupTableSize,
+ *      &h1, &h2, &h3, &h4, &phi1, &phi2, &phi3, &phi4);
+ * @endcode
+ * @param angleInDegree[] Input array with the angle in degree.
+ * @param cubicCoefficients[] Output array with the c0, c1, c2, c3 coefficients of every segment (4*@p sizeAngleArray values).
+ * @param sizeAngleArray size of the array provided to this function.
+ * @param pH1 Pointer to H1 harmonic amplitude.
+ * @param pH2 Pointer to H2 harmonic amplitude.
+ * @param pH3 Pointer to H3 harmonic amplitude.
+ * @param pH4 Pointer to H4 harmonic amplitude.
+ * @param pPhi1 Pointer to Phi1 harmonic phase.
+ * @param pPhi2 Pointer to Phi2 harmonic phase.
+ * @param pPhi3 Pointer to Phi3 harmonic phase.
+ * @param pPhi4 Pointer to Phi4 harmonic phase.
+ * @return #CALIBRATION_SUCCESS or #CALIBRATION_ERROR_NULL_POINTER.
+ */
+unsigned char generateAngleErrorLookupTableUsingCubicCoefficients(float angleInDegree[],
+                                                                  float cubicCoefficients[],
+                                                                  const unsigned int sizeAngleArray,
+                                                                  float *pH1,
+                                                                  float *pH2,
+                                                                  float *pH3,
+                                                                  float *pH4,
+                                                                  float *pPhi1,
+                                                                  float *pPhi2,
+                                                                  float *pPhi3,
+                                                                  float *pPhi4);
+
+/**
+ * @brief Generate a family of lookup tables and their worst case
+ * interpolation error in a single pass.
+ *
+ * The fitted curve is evaluated once on a dense grid of @p denseSize
+ * angles evenly spaced over 360 degree (angle i is i*360/@p denseSize).
+ * Every lookup table of the family uses a subset of this grid as nodes,
+ * so no additional model evaluation is required to build them. Use
+ * #extractLookupTableFromDenseCurve, #extractConstantsAndSlopesFromDenseCurve
+ * and #extractCubicCoefficientsFromDenseCurve to get the tables of a given
+ * size. The slope of the fitted curve, needed by the cubic tables, is
+ * evaluated in the same pass when @p denseAngleErrorSlopes is not NULL.
+ *
+ * For each size of @p lookupTableSizes[], the worst case error of the
+ * linear interpolation (see #interpolateAngleFromFittedCurve) against the
+ * dense curve is returned in @p maxInterpolationErrorInDegree[].
+ *
+ * See below a function call example:
+ * @code{.c}
+ * const unsigned int denseSize = 4096;
+ * const unsigned int lookupTableNumber = 5;
+ * unsigned int lookupTableSizes[lookupTableNumber] = {16, 32, 64, 128, 256};
+ * //from extractAngleErrorHarmonics function
+ * float h1, h2, h3, h4;
+ * float phi1, phi2, phi3, phi4;
+ * //output parameters
+ * float denseAngleErrorInDegree[denseSize];
+ * float denseAngleErrorSlopes[denseSize];
+ * float maxInterpolationErrorInDegree[lookupTableNumber];
+ * generateMultiResolutionAngleErrorLookupTables(denseAngleErrorInDegree, denseAngleErrorSlopes, denseSize,
+ *      lookupTableSizes, maxInterpolationErrorInDegree, lookupTableNumber,
+ *      &h1, &h2, &h3, &h4, &phi1, &phi2, &phi3, &phi4);
+ * @endcode
+ * @param denseAngleErrorInDegree[] Output array with the fitted angle error on the dense grid.
+ * @param denseAngleErrorSlopes[] Output array with the slope of the fitted curve on the dense grid, in degree of error per degree of angle (NULL if not needed).
+ * @param denseSize Size of the dense grid, a multiple of every lookup table size.
+ * @param lookupTableSizes[] Input array with the lookup table sizes to evaluate, typically powers of two.
+ * @param maxInterpolationErrorInDegree[] Output array with the worst case interpolation error of each lookup table.
+ * @param lookupTableNumber Number of lookup table sizes.
+ * @param pH1 Pointer to H1 harmonic amplitude.
+ * @param pH2 Pointer to H2 harmonic amplitude.
+ * @param pH3 Pointer to H3 harmonic amplitude.
+ * @param pH4 Pointer to H4 harmonic amplitude.
+ * @param pPhi1 Pointer to Phi1 harmonic phase.
+ * @param pPhi2 Pointer to Phi2 harmonic phase.
+ * @param pPhi3 Pointer to Phi3 harmonic phase.
+ * @param pPhi4 Pointer to Phi4 harmonic phase.
+ * @return #CALIBRATION_SUCCESS, #CALIBRATION_ERROR_NULL_POINTER or
+ * #CALIBRATION_ERROR_INVALID_SIZE if a lookup table size does not divide @p denseSize.
+ */
+unsigned char generateMultiResolutionAngleErrorLookupTables(float denseAngleErrorInDegree[],
+                                                            float denseAngleErrorSlopes[],
+                                                            const unsigned int denseSize,
+                                                            const unsigned int lookupTableSizes[],
+                                                            float maxInterpolationErrorInDegree[],
+                                                            const unsigned int lookupTableNumber,
+                                                            float *pH1,
+                                                            float *pH2,
+                                                            float *pH3,
+                                                            float *pH4,
+                                                            float *pPhi1,
+                                                            float *pPhi2,
+                                                            float *pPhi3,
+                                                            float *pPhi4);
+
+/**
+ * @brief Extract a lookup table from the dense curve computed by
+ * #generateMultiResolutionAngleErrorLookupTables.
+ *
+ * The result is the same as #generateAngleErrorLookupTableUsingFittedCurve
+ * called with angles evenly spaced over 360 degree.
+ *
+ * @param denseAngleErrorInDegree[] Input array with the fitted angle error on the dense grid.
+ * @param denseSize Size of the dense grid.
+ * @param angleErrorInDegree[] Output array with the angle error lookup table.
+ * @param lookupTableSize Size of the lookup table, must divide @p denseSize.
+ * @return #CALIBRATION_SUCCESS, #CALIBRATION_ERROR_NULL_POINTER or
+ * #CALIBRATION_ERROR_INVALID_SIZE if @p lookupTableSize does not divide @p denseSize.
+ */
+unsigned char extractLookupTableFromDenseCurve( float denseAngleErrorInDegree[],
+                                                const unsigned int denseSize,
+                                                float angleErrorInDegree[],
+                                                const unsigned int lookupTableSize);
+
+/**
+ * @brief Extract a constants and slopes lookup table from the dense curve
+ * computed by #generateMultiResolutionAngleErrorLookupTables.
+ *
+ * The result is the same as #generateAngleErrorLookupTableUsingConstantsAndSlopes
+ * called with angles evenly spaced over 360 degree.
+ *
+ * @param denseAngleErrorInDegree[] Input array with the fitted angle error on the dense grid.
+ * @param denseSize Size of the dense grid.
+ * @param angleErrorConstants[] Output array with the constants of every segment.
+ * @param angleErrorSlopes[] Output array with the slopes of every segment.
+ * @param lookupTableSize Size of the lookup table, at least 2, must divide @p denseSize.
+ * @return #CALIBRATION_SUCCESS, #CALIBRATION_ERROR_NULL_POINTER or
+ * #CALIBRATION_ERROR_INVALID_SIZE if @p lookupTableSize is smaller than 2 or does not divide @p denseSize.
+ */
+unsigned char extractConstantsAndSlopesFromDenseCurve(  float denseAngleErrorInDegree[],
+                                                        const unsigned int denseSize,
+                                                        float angleErrorConstants[],
+                                                        float angleErrorSlopes[],
+                                                        const unsigned int lookupTableSize);
+
+/**
+ * @brief Extract a cubic coefficients lookup table from the dense curve and
+ * slopes computed by #generateMultiResolutionAngleErrorLookupTables.
+ *
+ * The result is the same as #generateAngleErrorLookupTableUsingCubicCoefficients
+ * called with angles evenly spaced over 360 degree.
+ *
+ * @param denseAngleErrorInDegree[] Input array with the fitted angle error on the dense grid.
+ * @param denseAngleErrorSlopes[] Input array with the slope of the fitted curve on the dense grid.
+ * @param denseSize Size of the dense grid.
+ * @param cubicCoefficients[] Output array with the c0, c1, c2, c3 coefficients of every segment (4*@p lookupTableSize values).
+ * @param lookupTableSize Size of the lookup table, must divide @p denseSize.
+ * @return #CALIBRATION_SUCCESS, #CALIBRATION_ERROR_NULL_POINTER or
+ * #CALIBRATION_ERROR_INVALID_SIZE if @p lookupTableSize does not divide @p denseSize.
+ */
+unsigned char extractCubicCoefficientsFromDenseCurve(   float denseAngleErrorInDegree[],
+                                                        float denseAngleErrorSlopes[],
+                                                        const unsigned int denseSize,
+                                                        float cubicCoefficients[],
+                                                        const unsigned int lookupTableSize);
+
+/**
+ * @brief Initialize a calibration context.
+ *
+ * The context keeps a reference on @p scratchBuffer, which must stay valid
+ * until #calibrationContextDestroy. No memory is allocated by the context
+ * functions.
+ *
+ * See below the context life cycle:
+ * @code{.c}
+ * const unsigned int maxSizeAngleArray = 1000;
+ * float scratchBuffer[maxSizeAngleArray];
+ * magalpha_calib_ctx context;
+ * calibrationContextInit(&context, scratchBuffer, maxSizeAngleArray);
+ * //for every recalibration
+ * if (calibrationContextCompute(&context, referenceAngleInDegree, measuredAngleInDegree, sizeAngleArray) == CALIBRATION_SUCCESS)
+ * {
+ *     calibrationContextGenerateLookupTable(&context, lookupTableInputAngleArray, angleErrorInDegree, lookupTableSize);
+ * }
+ * calibrationContextDestroy(&context);
+ * @endcode
+ * @param pContext Context to initialize.
+ * @param scratchBuffer[] Buffer used to store the angle error, owned by the caller.
+ * @param scratchSize Size of @p scratchBuffer, maximum number of samples per computation.
+ * @return #CALIBRATION_SUCCESS, #CALIBRATION_ERROR_NULL_POINTER or
+ * #CALIBRATION_ERROR_INVALID_SIZE if @p scratchSize is 0.
+ */
+unsigned char calibrationContextInit(   magalpha_calib_ctx *pContext,
+                                        float scratchBuffer[],
+                                        const unsigned int scratchSize);
+
+/**
+ * @brief Extract the harmonics from the measured angle values into the context.
+ *
+ * Same as #extractAngleErrorHarmonics, the angle error is stored in the
+ * context scratch buffer and the harmonics in the context.
+ *
+ * @param pContext Initialized context.
+ * @param referenceAngleInDegree[] Input array with the refereance angle set on the calibration setup.
+ * @param measuredAngleInDegree[] Input array with the angle in degree measured by the sensor.
+ * @param sizeAngleArray size of the array provided to this function.
+ * @return #CALIBRATION_SUCCESS, #CALIBRATION_ERROR_NULL_POINTER,
+ * #CALIBRATION_ERROR_INVALID_SIZE or #CALIBRATION_ERROR_BUFFER_TOO_SMALL.
+ */
+unsigned char calibrationContextCompute(magalpha_calib_ctx *pContext,
+                                        float referenceAngleInDegree[],
+                                        float measuredAngleInDegree[],
+                                        const unsigned int sizeAngleArray);
+
+/**
+ * @brief Extract the harmonics from the raw sensor codes into the context.
+ *
+ * Same as #extractAngleErrorHarmonicsFromRawData, the angle error is stored
+ * in the context scratch buffer and the harmonics in the context.
+ *
+ * @param pContext Initialized context.
+ * @param rawAnglePairs[] Input array with the interleaved reference and sensor codes.
+ * @param fullScaleValue Number of codes per turn.
+ * @param sizeAngleArray Number of (reference, sensor) pairs provided to this function.
+ * @return #CALIBRATION_SUCCESS, #CALIBRATION_ERROR_NULL_POINTER,
+ * #CALIBRATION_ERROR_INVALID_SIZE, #CALIBRATION_ERROR_INVALID_PARAMETER or
+ * #CALIBRATION_ERROR_BUFFER_TOO_SMALL.
+ */
+unsigned char calibrationContextComputeFromRawData( magalpha_calib_ctx *pContext,
+                                                    const unsigned short rawAnglePairs[],
+                                                    const unsigned int fullScaleValue,
+                                                    const unsigned int sizeAngleArray);
+
+/**
+ * @brief Generate the angle error lookup table using the fitted curve of the context.
+ *
+ * See #generateAngleErrorLookupTableUsingFittedCurve.
+ *
+ * @param pContext Context with computed harmonics.
+ * @param angleInDegree[] Input array with the angle in degree.
+ * @param fittedAngleErrorInDegree[] Output array with the fitted curve of the angle error in degree.
+ * @param sizeAngleArray size of the array provided to this function.
+ * @return #CALIBRATION_SUCCESS, #CALIBRATION_ERROR_NULL_POINTER or
+ * #CALIBRATION_ERROR_NOT_COMPUTED.
+ */
+unsigned char calibrationContextGenerateLookupTable( magalpha_calib_ctx *pContext,
+                                                    float angleInDegree[],
+                                                    float fittedAngleErrorInDegree[],
+                                                    const unsigned int sizeAngleArray);
+
+/**
+ * @brief Generate the constants and slopes lookup table of the context.
+ *
+ * See #generateAngleErrorLookupTableUsingConstantsAndSlopes.
+ *
+ * @param pContext Context with computed harmonics.
+ * @param angleInDegree[] Input array with the angle in degree.
+ * @param angleErrorConstants[] Output array with the constants of the angle error in degree.
+ * @param angleErrorSlopes[] Output array with the slopes of the angle error.
+ * @param sizeAngleArray size of the array provided to this function.
+ * @return #CALIBRATION_SUCCESS, #CALIBRATION_ERROR_NULL_POINTER,
+ * #CALIBRATION_ERROR_INVALID_SIZE or #CALIBRATION_ERROR_NOT_COMPUTED.
+ */
+unsigned char calibrationContextGenerateConstantsAndSlopes(  magalpha_calib_ctx *pContext,
+                                                            float angleInDegree[],
+                                                            float angleErrorConstants[],
+                                                            float angleErrorSlopes[],
+                                                            const unsigned int sizeAngleArray);
+
+/**
+ * @brief Generate the cubic coefficients lookup table of the context.
+ *
+ * See #generateAngleErrorLookupTableUsingCubicCoefficients.
+ *
+ * @param pContext Context with computed harmonics.
+ * @param angleInDegree[] Input array with the angle in degree.
+ * @param cubicCoefficients[] Output array with the c0, c1, c2, c3 coefficients of every segment.
+ * @param sizeAngleArray size of the array provided to this function.
+ * @return #CALIBRATION_SUCCESS, #CALIBRATION_ERROR_NULL_POINTER or
+ * #CALIBRATION_ERROR_NOT_COMPUTED.
+ */
+unsigned char calibrationContextGenerateCubicCoefficients(   magalpha_calib_ctx *pContext,
+                                                            float angleInDegree[],
+                                                            float cubicCoefficients[],
+                                                            const unsigned int sizeAngleArray);
+
+/**
+ * @brief Release the context.
+ *
+ * The scratch buffer is not freed, it belongs to the caller.
+ *
+ * @param pContext Context to release.
+ */
+void calibrationContextDestroy(magalpha_calib_ctx *pContext);
+
 #if defined __cplusplus
 }
 #endif
@@ -0,0 +1,90 @@
+#include <QByteArray>
+#include <QList>
+#include <QVector>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "calibrationcurvegenerator.h"
+#include "csvcapture.h"
+#include "rawcapture.h"
+
+//Independent count of the rows the CSV loader must return: one per non-blank line after the header
+static int nonBlankLineNumber(const QByteArray &text)
+{
+    int lineNumber = 0;
+    const QList<QByteArray> lines = text.split('\n');
+    for (int i = 0; i < lines.size(); ++i)
+    {
+        if (!lines[i].trimmed().isEmpty())
+        {
+            ++lineNumber;
+        }
+    }
+    return lineNumber;
+}
+
+//Feeds the input to the same loaders as the application: a raw capture when it starts with the
+//raw capture magic, a CSV capture otherwise, then extracts the harmonics of the accepted captures.
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    float h[CALIBRATION_HARMONIC_NUMBER];
+    float phi[CALIBRATION_HARMONIC_NUMBER];
+    if (isRawCapture(data, size))
+    {
+        RawCaptureHeader header;
+        QString errorMessage;
+        if (!readRawCaptureHeader(data, size, &header, &errorMessage))
+        {
+            return 0;
+        }
+        //the application uses the mapped file, which is aligned, the fuzzer input may not be
+        QVector<unsigned short> rawAnglePairs(2*header.sampleCount);
+        memcpy(rawAnglePairs.data(), data+header.headerSize, 4*header.sampleCount);
+        const unsigned char status = extractAngleErrorHarmonicsFromRawData(rawAnglePairs.constData(), header.fullScaleValue, NULL, header.sampleCount,
+                                                                           &h[0], &h[1], &h[2], &h[3], &phi[0], &phi[1], &phi[2], &phi[3]);
+        //codes are bounded, the harmonics of an accepted capture must be finite
+        for (unsigned int k = 0; status == CALIBRATION_SUCCESS && k < CALIBRATION_HARMONIC_NUMBER; ++k)
+        {
+            if (!std::isfinite(h[k]) || h[k] < 0.0 || h[k] > 720.0 || !std::isfinite(phi[k]))
+            {
+                abort();
+            }
+        }
+        if (status != CALIBRATION_SUCCESS && status != CALIBRATION_ERROR_INVALID_PARAMETER)
+        {
+            abort();
+        }
+        return 0;
+    }
+    QVector<float> referenceAngleArray;
+    QVector<float> measuredAngleArray;
+    const char *fileBegin = reinterpret_cast<const char *>(data);
+    const bool loaded = loadCsvCapture(fileBegin, fileBegin+size, 360.0, referenceAngleArray, measuredAngleArray, false);
+    //no row may be dropped or duplicated, a file without any row is rejected
+    const QByteArray text(fileBegin, size);
+    const int headerEnd = text.indexOf('\n');
+    const int expectedRowNumber = (headerEnd < 0) ? 0 : nonBlankLineNumber(text.mid(headerEnd+1));
+    if (loaded != (expectedRowNumber > 0))
+    {
+        abort();
+    }
+    if (!loaded)
+    {
+        return 0;
+    }
+    if (referenceAngleArray.size() != expectedRowNumber || measuredAngleArray.size() != expectedRowNumber)
+    {
+        abort();
+    }
+    //the parsed values may be inf or nan, only the status is checked
+    if (extractAngleErrorHarmonics(referenceAngleArray.data(), measuredAngleArray.data(), NULL, referenceAngleArray.size(),
+                                   &h[0], &h[1], &h[2], &h[3], &phi[0], &phi[1], &phi[2], &phi[3]) != CALIBRATION_SUCCESS)
+    {
+        abort();
+    }
+    return 0;
+}
@@ -0,0 +1,33 @@
+QT += core concurrent
+QT -= gui
+
+CONFIG += c++11
+
+TARGET = ma-cal-fuzzer
+DESTDIR = "../../bin"
+CONFIG += console
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+# libFuzzer target, requires clang
+QMAKE_CC = clang
+QMAKE_CXX = clang++
+QMAKE_LINK = clang++
+QMAKE_CFLAGS += -g -fsanitize=fuzzer-no-link,address
+QMAKE_CXXFLAGS += -g -fsanitize=fuzzer-no-link,address
+QMAKE_LFLAGS += -fsanitize=fuzzer,address
+
+INCLUDEPATH += \
+    ../calibration-curve-generator \
+    ../ma-cal-generator
+
+SOURCES += fuzzer.cpp \
+    ../ma-cal-generator/csvcapture.cpp \
+    ../ma-cal-generator/rawcapture.cpp \
+    ../calibration-curve-generator/calibrationcurvegenerator.c
+
+HEADERS += \
+    ../ma-cal-generator/csvcapture.h \
+    ../ma-cal-generator/rawcapture.h \
+    ../calibration-curve-generator/calibrationcurvegenerator.h
@@ -0,0 +1,90 @@
+#include "benchmark.h"
+
+#include <QElapsedTimer>
+#include <QVector>
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+#include "calibrationcurvegenerator.h"
+#include "angleinterpolation.h"
+
+static const unsigned int BENCHMARKANGLENUMBER = 1 << 20;
+
+static float maxAbsoluteDifference(const QVector<float> &a, const QVector<float> &b)
+{
+    float maxDifference = 0.0;
+    for (int i = 0; i < a.size(); ++i)
+    {
+        maxDifference = qMax(maxDifference, std::fabs(a[i]-b[i]));
+    }
+    return maxDifference;
+}
+
+void runInterpolationBenchmark(float *pH1,
+                               float *pH2,
+                               float *pH3,
+                               float *pH4,
+                               float *pPhi1,
+                               float *pPhi2,
+                               float *pPhi3,
+                               float *pPhi4)
+{
+    //deterministic angles spread over the whole turn
+    QVector<float> angleArray(BENCHMARKANGLENUMBER);
+    quint32 seed = 12345;
+    for (unsigned int i = 0; i < BENCHMARKANGLENUMBER; ++i)
+    {
+        seed = seed*1664525u+1013904223u;
+        angleArray[i] = (float)(seed >> 8)*(360.0/16777216.0);
+    }
+    QVector<float> referenceErrorArray(BENCHMARKANGLENUMBER);
+    generateAngleErrorLookupTableUsingFittedCurve(angleArray.data(), referenceErrorArray.data(), BENCHMARKANGLENUMBER,
+                                                  pH1, pH2, pH3, pH4, pPhi1, pPhi2, pPhi3, pPhi4);
+    QVector<float> correctedAngleArray(BENCHMARKANGLENUMBER);
+    QVector<float> angleErrorArray(BENCHMARKANGLENUMBER);
+    QElapsedTimer timer;
+    const size_t WIDTH = 22;
+    std::cout << "\n\nInterpolation Benchmark (" << BENCHMARKANGLENUMBER << " angles)" << std::endl;
+    std::cout << std::left << std::setw(WIDTH) << "Size" << std::setw(WIDTH) << "Linear max error" << std::setw(WIDTH) << "Linear ns/angle" <<
+                 std::setw(WIDTH) << "Cubic max error" << std::setw(WIDTH) << "Cubic ns/angle" << std::setw(WIDTH) << "Cubic batch ns/angle" << std::endl;
+    for (unsigned int lookupTableSize = 4; lookupTableSize <= 256; lookupTableSize *= 2)
+    {
+        QVector<float> lookupTableAngleArray(lookupTableSize);
+        for (unsigned int i = 0; i < lookupTableSize; ++i)
+        {
+            lookupTableAngleArray[i] = (float)i*360.0/(float)lookupTableSize;
+        }
+        QVector<float> lookupTableFittedArray(lookupTableSize);
+        generateAngleErrorLookupTableUsingFittedCurve(lookupTableAngleArray.data(), lookupTableFittedArray.data(), lookupTableSize,
+                                                      pH1, pH2, pH3, pH4, pPhi1, pPhi2, pPhi3, pPhi4);
+        QVector<float> cubicCoefficientArray(4*lookupTableSize);
+        generateAngleErrorLookupTableUsingCubicCoefficients(lookupTableAngleArray.data(), cubicCoefficientArray.data(), lookupTableSize,
+                                                            pH1, pH2, pH3, pH4, pPhi1, pPhi2, pPhi3, pPhi4);
+        //both methods are timed with one scalar call per angle, so only the interpolation method differs
+        timer.start();
+        for (unsigned int i = 0; i < BENCHMARKANGLENUMBER; ++i)
+        {
+            correctedAngleArray[i] = interpolateAngleFromFittedCurve(angleArray[i], lookupTableAngleArray.data(), lookupTableFittedArray.data(),
+                                                                     lookupTableSize, 0.0, &angleErrorArray[i]);
+        }
+        const double linearTime = (double)timer.nsecsElapsed()/BENCHMARKANGLENUMBER;
+        const float linearError = maxAbsoluteDifference(angleErrorArray, referenceErrorArray);
+        timer.start();
+        for (unsigned int i = 0; i < BENCHMARKANGLENUMBER; ++i)
+        {
+            correctedAngleArray[i] = interpolateAngleFromCubicCoefficients(angleArray[i], cubicCoefficientArray.data(),
+                                                                           lookupTableSize, 0.0, &angleErrorArray[i]);
+        }
+        const double cubicTime = (double)timer.nsecsElapsed()/BENCHMARKANGLENUMBER;
+        const float cubicError = maxAbsoluteDifference(angleErrorArray, referenceErrorArray);
+        //the batch call of the same cubic method, for the gain of the batch path alone
+        timer.start();
+        interpolateAngleArrayFromCubicCoefficients(angleArray.data(), correctedAngleArray.data(), angleErrorArray.data(), BENCHMARKANGLENUMBER,
+                                                   cubicCoefficientArray.data(), lookupTableSize, 0.0);
+        const double cubicBatchTime = (double)timer.nsecsElapsed()/BENCHMARKANGLENUMBER;
+        std::cout << std::left << std::setw(WIDTH) << lookupTableSize << std::setw(WIDTH) << linearError << std::setw(WIDTH) << linearTime <<
+                     std::setw(WIDTH) << cubicError << std::setw(WIDTH) << cubicTime << std::setw(WIDTH) << cubicBatchTime << std::endl;
+    }
+}
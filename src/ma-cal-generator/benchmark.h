@@ -0,0 +1,60 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Mathieu Kaelin for Monolithic Power Systems
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+/**
+ * @file benchmark.h
+ * @brief Accuracy and latency benchmark of the interpolation methods.
+ */
+
+/**
+ * @brief Compare the linear and the cubic interpolation for several lookup
+ * table sizes.
+ *
+ * The lookup tables are generated from the given harmonics. For every size,
+ * the worst case error against the fitted curve and the time per
+ * interpolated angle are printed on the console. The linear and cubic
+ * methods are both timed with one scalar call per angle; the time of the
+ * cubic batch call is printed separately.
+ *
+ * @param pH1 Pointer to H1 harmonic amplitude.
+ * @param pH2 Pointer to H2 harmonic amplitude.
+ * @param pH3 Pointer to H3 harmonic amplitude.
+ * @param pH4 Pointer to H4 harmonic amplitude.
+ * @param pPhi1 Pointer to Phi1 harmonic phase.
+ * @param pPhi2 Pointer to Phi2 harmonic phase.
+ * @param pPhi3 Pointer to Phi3 harmonic phase.
+ * @param pPhi4 Pointer to Phi4 harmonic phase.
+ */
+void runInterpolationBenchmark(float *pH1,
+                               float *pH2,
+                               float *pH3,
+                               float *pH4,
+                               float *pPhi1,
+                               float *pPhi2,
+                               float *pPhi3,
+                               float *pPhi4);
+
+#endif // BENCHMARK_H
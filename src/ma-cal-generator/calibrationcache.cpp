@@ -0,0 +1,72 @@
+#include "calibrationcache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+
+static const quint32 CACHEMAGIC = 0x4D434348; //MCCH
+//part of the key, bumped whenever the extraction gives different harmonics (2: single pass extraction with double sums)
+static const quint32 CACHEVERSION = 2;
+
+static QString cacheFilePath(const QString &cacheDirectory, const QByteArray &key)
+{
+    return QDir(cacheDirectory).filePath(QString::fromLatin1(key.toHex()) + ".cache");
+}
+
+QByteArray calibrationCacheKey(const uchar *data, qint64 size, unsigned int harmonicNumber, float fullScaleValue)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    QByteArray parameters;
+    QDataStream parametersStream(&parameters, QIODevice::WriteOnly);
+    parametersStream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    parametersStream << CACHEVERSION << (quint32)harmonicNumber << fullScaleValue;
+    hash.addData(parameters);
+    //feed the capture by block, QCryptographicHash::addData takes an int length
+    const qint64 BLOCKSIZE = 1 << 30;
+    for (qint64 offset = 0; offset < size; offset += BLOCKSIZE)
+    {
+        hash.addData(reinterpret_cast<const char *>(data+offset), (int)qMin(BLOCKSIZE, size-offset));
+    }
+    return hash.result();
+}
+
+bool readCalibrationCache(const QString &cacheDirectory, const QByteArray &key, CalibrationCacheEntry *pEntry)
+{
+    QFile file(cacheFilePath(cacheDirectory, key));
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    QDataStream input(&file);
+    input.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    quint32 magic;
+    quint32 version;
+    QByteArray storedKey;
+    quint32 dataLength;
+    input >> magic >> version >> storedKey >> dataLength;
+    input >> pEntry->h1 >> pEntry->h2 >> pEntry->h3 >> pEntry->h4;
+    input >> pEntry->phi1 >> pEntry->phi2 >> pEntry->phi3 >> pEntry->phi4;
+    pEntry->dataLength = dataLength;
+    return (input.status() == QDataStream::Ok) && (magic == CACHEMAGIC) && (version == CACHEVERSION) && (storedKey == key);
+}
+
+bool writeCalibrationCache(const QString &cacheDirectory, const QByteArray &key, const CalibrationCacheEntry &entry)
+{
+    if (!QDir().mkpath(cacheDirectory))
+    {
+        return false;
+    }
+    QSaveFile file(cacheFilePath(cacheDirectory, key));
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+    QDataStream output(&file);
+    output.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    output << CACHEMAGIC << CACHEVERSION << key << (quint32)entry.dataLength;
+    output << entry.h1 << entry.h2 << entry.h3 << entry.h4;
+    output << entry.phi1 << entry.phi2 << entry.phi3 << entry.phi4;
+    return file.commit();
+}
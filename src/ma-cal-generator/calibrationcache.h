@@ -0,0 +1,84 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Mathieu Kaelin for Monolithic Power Systems
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+#ifndef CALIBRATIONCACHE_H
+#define CALIBRATIONCACHE_H
+
+#include <QByteArray>
+#include <QString>
+
+/**
+ * @file calibrationcache.h
+ * @brief On-disk cache of the harmonics extracted from a capture.
+ *
+ * A cache entry is stored in a file named after the hexadecimal cache key.
+ * The key is the SHA-256 of the capture content and of the extraction
+ * parameters, so an entry is never reused once the input or the parameters
+ * change.
+ */
+
+struct CalibrationCacheEntry
+{
+    unsigned int dataLength;
+    float h1;
+    float h2;
+    float h3;
+    float h4;
+    float phi1;
+    float phi2;
+    float phi3;
+    float phi4;
+};
+
+/**
+ * @brief Compute the cache key of a capture.
+ *
+ * @param data Capture file content
+ * @param size Size of the capture file content in byte
+ * @param harmonicNumber Number of extracted harmonics
+ * @param fullScaleValue Full scale value used to convert the input in degree
+ * @return cache key
+ */
+QByteArray calibrationCacheKey(const uchar *data, qint64 size, unsigned int harmonicNumber, float fullScaleValue);
+
+/**
+ * @brief Read a cache entry.
+ *
+ * @param cacheDirectory Directory containing the cache files
+ * @param key Cache key computed with #calibrationCacheKey
+ * @param pEntry Cached harmonics
+ * @return true if a valid entry exists for @p key
+ */
+bool readCalibrationCache(const QString &cacheDirectory, const QByteArray &key, CalibrationCacheEntry *pEntry);
+
+/**
+ * @brief Write a cache entry, the file is replaced atomically.
+ *
+ * @param cacheDirectory Directory containing the cache files, created if needed
+ * @param key Cache key computed with #calibrationCacheKey
+ * @param entry Harmonics to cache
+ * @return true on success
+ */
+bool writeCalibrationCache(const QString &cacheDirectory, const QByteArray &key, const CalibrationCacheEntry &entry);
+
+#endif // CALIBRATIONCACHE_H
@@ -0,0 +1,219 @@
+#include "calibrationserver.h"
+
+#include <QLocalSocket>
+#include <QtEndian>
+
+#include <cstring>
+
+static const char REQUESTMAGIC[4] = {'M', 'A', 'C', 'R'};
+static const char RESPONSEMAGIC[4] = {'M', 'A', 'C', 'A'};
+static const int REQUESTHEADERSIZE = 24;
+static const quint32 MAXLOOKUPTABLESIZE = 4096;
+
+static void writeUInt32(char *destination, quint32 value)
+{
+    qToLittleEndian<quint32>(value, reinterpret_cast<uchar *>(destination));
+}
+
+static void writeFloats(char *destination, const float *values, int count)
+{
+    quint32 bits;
+    for (int i = 0; i < count; ++i)
+    {
+        memcpy(&bits, &values[i], sizeof(bits));
+        writeUInt32(destination+4*i, bits);
+    }
+}
+
+CalibrationServer::CalibrationServer(unsigned int sampleRingSize, QObject *parent) :
+    QObject(parent),
+    m_sampleRingSize(sampleRingSize),
+    m_scratchBuffer(sampleRingSize)
+{
+    calibrationContextInit(&m_context, m_scratchBuffer.data(), m_scratchBuffer.size());
+    //the biggest payload is a degree payload of a full ring, no request needs more
+    m_requestPayload.resize(sampleRingSize*2*sizeof(float));
+    m_response.reserve(48+7*MAXLOOKUPTABLESIZE*sizeof(float));
+    m_lookupTableAngle.reserve(MAXLOOKUPTABLESIZE);
+    m_lookupTableFitted.reserve(MAXLOOKUPTABLESIZE);
+    m_lookupTableConstants.reserve(MAXLOOKUPTABLESIZE);
+    m_lookupTableSlopes.reserve(MAXLOOKUPTABLESIZE);
+    m_lookupTableCubicCoefficients.reserve(4*MAXLOOKUPTABLESIZE);
+    connect(&m_server, SIGNAL(newConnection()), this, SLOT(acceptConnection()));
+}
+
+CalibrationServer::~CalibrationServer()
+{
+    calibrationContextDestroy(&m_context);
+}
+
+bool CalibrationServer::start(const QString &serverName, QString *pErrorMessage)
+{
+    m_sampleRing.setKey(serverName + "-samples");
+    if (m_sampleRing.attach())
+    {
+        //release the segment left by a server which did not exit cleanly
+        m_sampleRing.detach();
+    }
+    if (!m_sampleRing.create(m_sampleRingSize*2*sizeof(quint16)))
+    {
+        *pErrorMessage = "unable to create the sample ring: " + m_sampleRing.errorString();
+        return false;
+    }
+    //remove the socket left by a server which did not exit cleanly
+    QLocalServer::removeServer(serverName);
+    if (!m_server.listen(serverName))
+    {
+        *pErrorMessage = "unable to listen on " + serverName + ": " + m_server.errorString();
+        return false;
+    }
+    return true;
+}
+
+void CalibrationServer::acceptConnection()
+{
+    while (m_server.hasPendingConnections())
+    {
+        QLocalSocket *socket = m_server.nextPendingConnection();
+        //a client can not make the server buffer more than one complete request
+        socket->setReadBufferSize(REQUESTHEADERSIZE+m_requestPayload.size());
+        connect(socket, SIGNAL(readyRead()), this, SLOT(readRequests()));
+        connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
+    }
+}
+
+void CalibrationServer::readRequests()
+{
+    QLocalSocket *socket = qobject_cast<QLocalSocket *>(sender());
+    if (socket == NULL)
+    {
+        return;
+    }
+    //several requests may be pipelined, process all the complete ones
+    while (processRequest(socket))
+    {
+    }
+}
+
+bool CalibrationServer::processRequest(QLocalSocket *socket)
+{
+    if (socket->bytesAvailable() < REQUESTHEADERSIZE)
+    {
+        return false;
+    }
+    const QByteArray header = socket->peek(REQUESTHEADERSIZE);
+    const uchar *headerData = reinterpret_cast<const uchar *>(header.constData());
+    const quint32 sampleSource = qFromLittleEndian<quint32>(headerData+4);
+    const quint32 fullScaleValue = qFromLittleEndian<quint32>(headerData+8);
+    const quint32 lookupTableSize = qFromLittleEndian<quint32>(headerData+12);
+    const quint32 sampleCount = qFromLittleEndian<quint32>(headerData+16);
+    const quint32 ringOffset = qFromLittleEndian<quint32>(headerData+20);
+    qint64 payloadSize = 0;
+    if (sampleSource == RawPayload)
+    {
+        payloadSize = (qint64)sampleCount*2*sizeof(quint16);
+    }
+    else if (sampleSource == DegreePayload)
+    {
+        payloadSize = (qint64)sampleCount*2*sizeof(float);
+    }
+    if (memcmp(headerData, REQUESTMAGIC, sizeof(REQUESTMAGIC)) != 0 ||
+        (sampleSource != RawPayload && sampleSource != DegreePayload && sampleSource != RawSampleRing) ||
+        lookupTableSize < 2 || lookupTableSize > MAXLOOKUPTABLESIZE ||
+        sampleCount > m_sampleRingSize)
+    {
+        writeResponse(socket, CALIBRATIONSERVER_ERROR_PROTOCOL, sampleCount, 0);
+        socket->disconnectFromServer();
+        return false;
+    }
+    if (socket->bytesAvailable() < REQUESTHEADERSIZE+payloadSize)
+    {
+        return false;
+    }
+    socket->read(REQUESTHEADERSIZE);
+    socket->read(m_requestPayload.data(), payloadSize);
+    unsigned char status = calibrate(sampleSource, fullScaleValue, sampleCount, ringOffset);
+    if (status == CALIBRATION_SUCCESS)
+    {
+        m_lookupTableAngle.resize(lookupTableSize);
+        m_lookupTableFitted.resize(lookupTableSize);
+        m_lookupTableConstants.resize(lookupTableSize);
+        m_lookupTableSlopes.resize(lookupTableSize);
+        m_lookupTableCubicCoefficients.resize(4*lookupTableSize);
+        for (quint32 i = 0; i < lookupTableSize; ++i)
+        {
+            m_lookupTableAngle[i] = (float)i*360.0/(float)lookupTableSize;
+        }
+        calibrationContextGenerateLookupTable(&m_context, m_lookupTableAngle.data(), m_lookupTableFitted.data(), lookupTableSize);
+        calibrationContextGenerateConstantsAndSlopes(&m_context, m_lookupTableAngle.data(), m_lookupTableConstants.data(),
+                                                     m_lookupTableSlopes.data(), lookupTableSize);
+        calibrationContextGenerateCubicCoefficients(&m_context, m_lookupTableAngle.data(), m_lookupTableCubicCoefficients.data(), lookupTableSize);
+    }
+    writeResponse(socket, status, sampleCount, (status == CALIBRATION_SUCCESS) ? lookupTableSize : 0);
+    return true;
+}
+
+unsigned char CalibrationServer::calibrate(quint32 sampleSource, quint32 fullScaleValue, quint32 sampleCount, quint32 ringOffset)
+{
+#if Q_BYTE_ORDER != Q_LITTLE_ENDIAN
+    //the samples are used in place and must already be in host order
+    return CALIBRATIONSERVER_ERROR_PROTOCOL;
+#endif
+    if (sampleSource == RawPayload)
+    {
+        return calibrationContextComputeFromRawData(&m_context, reinterpret_cast<const unsigned short *>(m_requestPayload.constData()),
+                                                    fullScaleValue, sampleCount);
+    }
+    if (sampleSource == DegreePayload)
+    {
+        float *referenceAngle = reinterpret_cast<float *>(m_requestPayload.data());
+        return calibrationContextCompute(&m_context, referenceAngle, referenceAngle+sampleCount, sampleCount);
+    }
+    if (ringOffset >= m_sampleRingSize)
+    {
+        return CALIBRATION_ERROR_INVALID_SIZE;
+    }
+    const unsigned short *rawAnglePairs = reinterpret_cast<const unsigned short *>(m_sampleRing.constData());
+    unsigned char status;
+    m_sampleRing.lock();
+    if (ringOffset+sampleCount <= m_sampleRingSize)
+    {
+        status = calibrationContextComputeFromRawData(&m_context, rawAnglePairs+2*ringOffset, fullScaleValue, sampleCount);
+    }
+    else
+    {
+        //the span wraps around the end of the ring, its two parts are joined in the request payload buffer
+        //which is twice as big as a full ring of pairs
+        const quint32 firstPartCount = m_sampleRingSize-ringOffset;
+        unsigned short *joinedAnglePairs = reinterpret_cast<unsigned short *>(m_requestPayload.data());
+        memcpy(joinedAnglePairs, rawAnglePairs+2*ringOffset, firstPartCount*2*sizeof(quint16));
+        memcpy(joinedAnglePairs+2*firstPartCount, rawAnglePairs, (sampleCount-firstPartCount)*2*sizeof(quint16));
+        status = calibrationContextComputeFromRawData(&m_context, joinedAnglePairs, fullScaleValue, sampleCount);
+    }
+    m_sampleRing.unlock();
+    return status;
+}
+
+void CalibrationServer::writeResponse(QLocalSocket *socket, quint32 status, quint32 sampleCount, quint32 lookupTableSize)
+{
+    m_response.resize(48+7*lookupTableSize*sizeof(float));
+    char *response = m_response.data();
+    memcpy(response, RESPONSEMAGIC, sizeof(RESPONSEMAGIC));
+    writeUInt32(response+4, status);
+    writeUInt32(response+8, sampleCount);
+    writeUInt32(response+12, lookupTableSize);
+    if (status == CALIBRATION_SUCCESS)
+    {
+        writeFloats(response+16, m_context.h, CALIBRATION_HARMONIC_NUMBER);
+        writeFloats(response+32, m_context.phi, CALIBRATION_HARMONIC_NUMBER);
+        writeFloats(response+48, m_lookupTableFitted.constData(), lookupTableSize);
+        writeFloats(response+48+4*lookupTableSize, m_lookupTableConstants.constData(), lookupTableSize);
+        writeFloats(response+48+8*lookupTableSize, m_lookupTableSlopes.constData(), lookupTableSize);
+        writeFloats(response+48+12*lookupTableSize, m_lookupTableCubicCoefficients.constData(), 4*lookupTableSize);
+    }
+    else
+    {
+        memset(response+16, 0, 32);
+    }
+    socket->write(m_response);
+}
@@ -0,0 +1,159 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Mathieu Kaelin for Monolithic Power Systems
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+#ifndef CALIBRATIONSERVER_H
+#define CALIBRATIONSERVER_H
+
+#include <QByteArray>
+#include <QLocalServer>
+#include <QObject>
+#include <QSharedMemory>
+#include <QString>
+#include <QVector>
+
+#include "calibrationcurvegenerator.h"
+
+class QLocalSocket;
+
+/**
+ * @file calibrationserver.h
+ * @brief Long-running local calibration service.
+ *
+ * The server listens on a local socket (Unix domain socket or Windows named
+ * pipe) and answers calibration requests. The calibration context, its
+ * scratch buffer and the request and response buffers are allocated once and
+ * reused by every request, so a request only costs the computation itself.
+ * The requests are processed one at a time, in the order they arrive.
+ *
+ * Large sample batches can be written by the client into the shared memory
+ * sample ring instead of being sent through the socket. The ring holds
+ * little-endian uint16 (reference code, sensor code) pairs, the client owns
+ * the write position and must not overwrite a region until the response of
+ * the request using it has been received. A request may start anywhere in
+ * the ring and wrap around its end, the sample following the last pair of
+ * the ring is the first one.
+ *
+ * All the fields are little-endian.
+ *
+ * Request (24 byte header followed by the optional payload):
+ * | Offset | Type    | Field                                                    |
+ * | :----- | :------ | :------------------------------------------------------- |
+ * | 0      | char[4] | Magic "MACR"                                             |
+ * | 4      | uint32  | Sample source, see #CalibrationServer::SampleSource      |
+ * | 8      | uint32  | Full scale value (raw sources only)                      |
+ * | 12     | uint32  | Lookup table size                                        |
+ * | 16     | uint32  | Sample count                                             |
+ * | 20     | uint32  | First sample index in the ring, below the ring size      |
+ *
+ * Response:
+ * | Offset | Type     | Field                                                   |
+ * | :----- | :------- | :------------------------------------------------------ |
+ * | 0      | char[4]  | Magic "MACA"                                            |
+ * | 4      | uint32   | Status, CALIBRATION_SUCCESS or an error code            |
+ * | 8      | uint32   | Sample count                                            |
+ * | 12     | uint32   | Lookup table size N (0 on error)                        |
+ * | 16     | float[4] | H1 to H4                                                |
+ * | 32     | float[4] | Phi1 to Phi4                                            |
+ * | 48     | float[N] | Fitted curve lookup table                               |
+ * |        | float[N] | Constants lookup table                                  |
+ * |        | float[N] | Slopes lookup table                                     |
+ * |        | float[4N]| Cubic coefficients lookup table                         |
+ *
+ * The lookup table angles are i*360/N.
+ *
+ * A request with more samples than the sample ring size is rejected with
+ * #CALIBRATIONSERVER_ERROR_PROTOCOL as soon as its header is received, the
+ * buffers never grow after the start.
+ */
+
+/** @brief Malformed request, the connection is closed after the response. */
+#define CALIBRATIONSERVER_ERROR_PROTOCOL    100
+
+/**
+ * @brief Biggest request payload in byte. A QByteArray holds at most 2^31-1
+ * byte including its allocation header and terminating zero, 256 byte are
+ * kept for them.
+ */
+#define CALIBRATIONSERVER_MAXPAYLOADSIZE    (0x7FFFFFFF-256)
+
+/** @brief Biggest sample ring, the degree payload of a full ring (2 float per sample) must fit in #CALIBRATIONSERVER_MAXPAYLOADSIZE. */
+#define CALIBRATIONSERVER_MAXSAMPLERINGSIZE (CALIBRATIONSERVER_MAXPAYLOADSIZE/(2*sizeof(float)))
+
+class CalibrationServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum SampleSource
+    {
+        RawPayload = 1,     ///< sample count uint16 pairs follow the header
+        DegreePayload = 2,  ///< sample count float reference angles then sample count float measured angles follow the header
+        RawSampleRing = 3   ///< the uint16 pairs are in the shared memory sample ring
+    };
+
+    /**
+     * @brief Create the server with its preallocated buffers.
+     *
+     * @param sampleRingSize Number of sample pairs of the shared memory ring
+     * and of the preallocated calibration scratch buffer, maximum number of
+     * samples of a request. At most #CALIBRATIONSERVER_MAXSAMPLERINGSIZE.
+     * @param parent Parent object
+     */
+    explicit CalibrationServer(unsigned int sampleRingSize, QObject *parent = 0);
+    ~CalibrationServer();
+
+    /**
+     * @brief Create the shared memory sample ring and start listening.
+     *
+     * The shared memory key is the server name followed by "-samples".
+     *
+     * @param serverName Name of the local socket
+     * @param pErrorMessage Reason of the failure
+     * @return true on success
+     */
+    bool start(const QString &serverName, QString *pErrorMessage);
+
+private slots:
+    void acceptConnection();
+    void readRequests();
+
+private:
+    bool processRequest(QLocalSocket *socket);
+    unsigned char calibrate(quint32 sampleSource, quint32 fullScaleValue, quint32 sampleCount, quint32 ringOffset);
+    void writeResponse(QLocalSocket *socket, quint32 status, quint32 sampleCount, quint32 lookupTableSize);
+
+    QLocalServer m_server;
+    QSharedMemory m_sampleRing;
+    unsigned int m_sampleRingSize;
+    QVector<float> m_scratchBuffer;
+    magalpha_calib_ctx m_context;
+    QByteArray m_requestPayload;
+    QByteArray m_response;
+    QVector<float> m_lookupTableAngle;
+    QVector<float> m_lookupTableFitted;
+    QVector<float> m_lookupTableConstants;
+    QVector<float> m_lookupTableSlopes;
+    QVector<float> m_lookupTableCubicCoefficients;
+};
+
+#endif // CALIBRATIONSERVER_H
@@ -0,0 +1,209 @@
+#include "csvcapture.h"
+
+#include <QThread>
+#include <QtConcurrent>
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+//captures bigger than this are only summarized on the console
+static const unsigned int MAXECHOEDROWS = 10000;
+
+struct CsvChunk
+{
+    const char *begin;
+    const char *end;
+    unsigned int firstRow;
+    unsigned int rowCount;
+    QList<QByteArray> conversionErrors;
+};
+
+static const char *nextLine(const char *position, const char *end)
+{
+    if (position >= end)
+    {
+        return end;
+    }
+    const char *lineFeed = static_cast<const char *>(memchr(position, '\n', end-position));
+    return (lineFeed == NULL) ? end : lineFeed+1;
+}
+
+static bool isBlankLine(const char *begin, const char *end)
+{
+    for (const char *c = begin; c < end; ++c)
+    {
+        if (!isspace(static_cast<unsigned char>(*c)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static float parseAngle(const char *begin, const char *end, bool *pConversionOk)
+{
+    char buffer[64];
+    char *conversionEnd;
+    float value;
+    while (begin < end && isspace(static_cast<unsigned char>(*begin)))
+    {
+        ++begin;
+    }
+    while (end > begin && isspace(static_cast<unsigned char>(*(end-1))))
+    {
+        --end;
+    }
+    const size_t length = end-begin;
+    if (length == 0 || length >= sizeof(buffer))
+    {
+        *pConversionOk = false;
+        return 0.0;
+    }
+    memcpy(buffer, begin, length);
+    buffer[length] = '\0';
+    value = strtof(buffer, &conversionEnd);
+    *pConversionOk = (conversionEnd == buffer+length);
+    return *pConversionOk ? value : 0.0;
+}
+
+static void countCsvRows(CsvChunk &chunk)
+{
+    unsigned int rowCount = 0;
+    for (const char *lineBegin = chunk.begin; lineBegin < chunk.end; )
+    {
+        const char *lineEnd = nextLine(lineBegin, chunk.end);
+        if (!isBlankLine(lineBegin, lineEnd))
+        {
+            ++rowCount;
+        }
+        lineBegin = lineEnd;
+    }
+    chunk.rowCount = rowCount;
+}
+
+static void parseCsvRows(CsvChunk &chunk, float rawToDegree, float referenceAngleArray[], float measuredAngleArray[])
+{
+    unsigned int row = chunk.firstRow;
+    bool conversionOk;
+    for (const char *lineBegin = chunk.begin; lineBegin < chunk.end; )
+    {
+        const char *lineEnd = nextLine(lineBegin, chunk.end);
+        if (!isBlankLine(lineBegin, lineEnd))
+        {
+            const char *separator = static_cast<const char *>(memchr(lineBegin, ',', lineEnd-lineBegin));
+            const char *fieldEnd = (separator == NULL) ? lineEnd : separator;
+            referenceAngleArray[row] = parseAngle(lineBegin, fieldEnd, &conversionOk)*rawToDegree;
+            if (conversionOk == false)
+            {
+                chunk.conversionErrors.append(QByteArray(lineBegin, fieldEnd-lineBegin).trimmed());
+            }
+            const char *fieldBegin = (separator == NULL) ? lineEnd : separator+1;
+            separator = static_cast<const char *>(memchr(fieldBegin, ',', lineEnd-fieldBegin));
+            fieldEnd = (separator == NULL) ? lineEnd : separator;
+            measuredAngleArray[row] = parseAngle(fieldBegin, fieldEnd, &conversionOk)*rawToDegree;
+            if (conversionOk == false)
+            {
+                chunk.conversionErrors.append(QByteArray(fieldBegin, fieldEnd-fieldBegin).trimmed());
+            }
+            ++row;
+        }
+        lineBegin = lineEnd;
+    }
+}
+
+bool loadCsvCapture(const char *fileBegin,
+                    const char *fileEnd,
+                    float fullScaleValue,
+                    QVector<float> &referenceAngleArray,
+                    QVector<float> &measuredAngleArray,
+                    bool verbose)
+{
+    //read header
+    const char *bodyBegin = nextLine(fileBegin, fileEnd);
+    QList<QByteArray> rowElement = QByteArray(fileBegin, bodyBegin-fileBegin).trimmed().split(',');
+    const size_t MAXWIDTH = 25;
+    if (verbose)
+    {
+        std::cout << std::left << std::setw(MAXWIDTH*2+4) << std::setfill('-') << "-" << std::endl;
+        std::cout << " "  << std::left << std::setw(MAXWIDTH) << std::setfill(' ') << qPrintable(rowElement.value(0)) <<
+                     "| " << std::left << std::setw(MAXWIDTH) << std::setfill(' ') << qPrintable(rowElement.value(1)) << "|" << std::endl;
+        std::cout << std::left << std::setw(MAXWIDTH*2+4) << std::setfill('-') << "-" << std::endl;
+    }
+    //split the data at line boundaries, one chunk per core
+    QVector<CsvChunk> chunks;
+    const qint64 bodySize = fileEnd-bodyBegin;
+    const int chunkNumber = qMax(1, QThread::idealThreadCount());
+    const char *chunkBegin = bodyBegin;
+    for (int i = 1; i <= chunkNumber && chunkBegin < fileEnd; ++i)
+    {
+        CsvChunk chunk;
+        chunk.begin = chunkBegin;
+        chunk.end = (i == chunkNumber) ? fileEnd : nextLine(bodyBegin+(bodySize*i)/chunkNumber, fileEnd);
+        if (chunk.end < chunk.begin)
+        {
+            chunk.end = chunk.begin;
+        }
+        chunk.firstRow = 0;
+        chunk.rowCount = 0;
+        chunks.append(chunk);
+        chunkBegin = chunk.end;
+    }
+    //count the rows of every chunk, then preallocate a single buffer per column
+    QtConcurrent::blockingMap(chunks, countCsvRows);
+    unsigned int rowNumber = 0;
+    for (int i = 0; i < chunks.size(); ++i)
+    {
+        chunks[i].firstRow = rowNumber;
+        rowNumber += chunks[i].rowCount;
+    }
+    if (rowNumber == 0)
+    {
+        if (verbose)
+        {
+            std::cout << "Error: the input file does not contain any data." << std::endl;
+        }
+        return false;
+    }
+    referenceAngleArray.resize(rowNumber);
+    measuredAngleArray.resize(rowNumber);
+    //read the data, the chunks are parsed in parallel straight into the final buffers
+    const float rawToDegree = 360.0/fullScaleValue;
+    float *referenceAngleBuffer = referenceAngleArray.data();
+    float *measuredAngleBuffer = measuredAngleArray.data();
+    QtConcurrent::blockingMap(chunks, [=](CsvChunk &chunk)
+    {
+        parseCsvRows(chunk, rawToDegree, referenceAngleBuffer, measuredAngleBuffer);
+    });
+    if (!verbose)
+    {
+        return true;
+    }
+    for (int i = 0; i < chunks.size(); ++i)
+    {
+        foreach (const QByteArray &field, chunks[i].conversionErrors)
+        {
+            std::cout << "Conversion Error! Not able to convert " << field.constData() << " to float" << std::endl;
+        }
+    }
+    if (rowNumber <= MAXECHOEDROWS)
+    {
+        for (const char *lineBegin = bodyBegin; lineBegin < fileEnd; lineBegin = nextLine(lineBegin, fileEnd))
+        {
+            rowElement = QByteArray(lineBegin, nextLine(lineBegin, fileEnd)-lineBegin).trimmed().split(',');
+            if (rowElement.size() < 2)
+            {
+                continue;
+            }
+            std::cout << " "  << std::left << std::setw(MAXWIDTH) << std::setfill(' ') << qPrintable(rowElement[0]) <<
+                         "| " << std::left << std::setw(MAXWIDTH) << std::setfill(' ')<< qPrintable(rowElement[1]) << "|" << std::endl;
+        }
+    }
+    else
+    {
+        std::cout << " " << rowNumber << " rows read with " << chunks.size() << " parallel chunks" << std::endl;
+    }
+    return true;
+}
@@ -0,0 +1,58 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Mathieu Kaelin for Monolithic Power Systems
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+#ifndef CSVCAPTURE_H
+#define CSVCAPTURE_H
+
+#include <QVector>
+
+/**
+ * @file csvcapture.h
+ * @brief Parallel parser of the CSV capture files.
+ */
+
+/**
+ * @brief Parse a CSV capture held in memory.
+ *
+ * The first line is the header. The data is split at line boundaries into one
+ * chunk per core and the chunks are parsed in parallel straight into
+ * @p referenceAngleArray and @p measuredAngleArray, which are allocated once.
+ * Blank lines are skipped, a field which can not be converted is read as 0.
+ *
+ * @param fileBegin Beginning of the file content, for example a mapped file
+ * @param fileEnd End of the file content
+ * @param fullScaleValue Full scale value of the input, 360.0 for an input in degree
+ * @param referenceAngleArray Reference angles in degree
+ * @param measuredAngleArray Measured angles in degree
+ * @param verbose Print the header, the conversion errors and the rows (up
+ * to 10000) on the console
+ * @return false if the file does not contain any data
+ */
+bool loadCsvCapture(const char *fileBegin,
+                    const char *fileEnd,
+                    float fullScaleValue,
+                    QVector<float> &referenceAngleArray,
+                    QVector<float> &measuredAngleArray,
+                    bool verbose);
+
+#endif // CSVCAPTURE_H
@@ -1,4 +1,4 @@
-QT += core
+QT += core concurrent network
 QT -= gui
 
 CONFIG += c++11
@@ -15,10 +15,20 @@ INCLUDEPATH += \
     ../angle-interpolation
 
 SOURCES += main.cpp \
+    csvcapture.cpp \
+    calibrationserver.cpp \
+    benchmark.cpp \
+    calibrationcache.cpp \
+    rawcapture.cpp \
     ../calibration-curve-generator/calibrationcurvegenerator.c \
     ../angle-interpolation/angleinterpolation.c
 
 HEADERS += \
+    csvcapture.h \
+    calibrationserver.h \
+    benchmark.h \
+    calibrationcache.h \
+    rawcapture.h \
     ../calibration-curve-generator/calibrationcurvegenerator.h \
     ../angle-interpolation/angleinterpolation.h
 
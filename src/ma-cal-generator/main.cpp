@@ -10,6 +10,11 @@
 
 #include "calibrationcurvegenerator.h"
 #include "angleinterpolation.h"
+#include "rawcapture.h"
+#include "calibrationcache.h"
+#include "benchmark.h"
+#include "calibrationserver.h"
+#include "csvcapture.h"
 
 static float modulo(float x, float y)
 {
@@ -22,13 +27,92 @@ static float angleOutputWithoutCorrection(float angleOutputInDegree, float zeroD
     return modulo(angleOutputInDegree+zeroDegreeOffset, 360.0);
 }
 
+//the angle error of calibration_curve.csv is a QVector<float>, a Qt allocation is limited to 2^31-1 byte
+//and 256 byte are kept for the allocation header
+static const quint64 REPORTMAXSAMPLECOUNT = (0x7FFFFFFF-256)/sizeof(float);
+
+//local socket name of the calibration daemon, the sample ring uses the same name followed by "-samples"
+static const char DAEMONSERVERNAME[] = "ma-cal-generator";
+
 int main(int argc, char *argv[])
 {
-    (void) argc;
-    (void) argv;
     QFile file;
     QFileInfo fileInfo;
-    if (argc < 2)
+    QString inputFileName;
+    bool useCache = true;
+    bool lookupTableOnly = false;
+    float maxInterpolationError = 0.0;
+    bool benchmark = false;
+    bool daemonMode = false;
+    unsigned int sampleRingSize = 1 << 20;
+    for (int i = 1; i < argc; ++i)
+    {
+        const QString argument = QString::fromLocal8Bit(argv[i]);
+        if (argument == "--no-cache")
+        {
+            useCache = false;
+        }
+        else if (argument == "--daemon")
+        {
+            daemonMode = true;
+        }
+        else if (argument == "--ring-size")
+        {
+            if (i+1 >= argc)
+            {
+                std::cout << "Error: missing value for " << argv[i] << std::endl;
+                return 1;
+            }
+            bool conversionOk;
+            sampleRingSize = QString::fromLocal8Bit(argv[++i]).toUInt(&conversionOk);
+            if (conversionOk == false || sampleRingSize == 0 || sampleRingSize > CALIBRATIONSERVER_MAXSAMPLERINGSIZE)
+            {
+                std::cout << "Error: invalid sample ring size " << argv[i] << ", at most " << CALIBRATIONSERVER_MAXSAMPLERINGSIZE << " samples" << std::endl;
+                return 1;
+            }
+        }
+        else if (argument == "--benchmark")
+        {
+            benchmark = true;
+        }
+        else if (argument == "--max-error")
+        {
+            if (i+1 >= argc)
+            {
+                std::cout << "Error: missing value for " << argv[i] << std::endl;
+                return 1;
+            }
+            bool conversionOk;
+            maxInterpolationError = QString::fromLocal8Bit(argv[++i]).toFloat(&conversionOk);
+            if (conversionOk == false || maxInterpolationError <= 0.0)
+            {
+                std::cout << "Error: invalid maximum interpolation error " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else if (argument == "--lut-only")
+        {
+            lookupTableOnly = true;
+        }
+        else
+        {
+            inputFileName = argument;
+        }
+    }
+    if (daemonMode)
+    {
+        QCoreApplication application(argc, argv);
+        CalibrationServer server(sampleRingSize);
+        QString errorMessage;
+        if (!server.start(DAEMONSERVERNAME, &errorMessage))
+        {
+            std::cout << "Error: Program not able to start the calibration daemon, " << qPrintable(errorMessage) << std::endl;
+            return 1;
+        }
+        std::cout << "Calibration daemon listening on " << DAEMONSERVERNAME << " with a " << sampleRingSize << " samples ring" << std::endl;
+        return application.exec();
+    }
+    if (inputFileName.isEmpty())
     {
         fileInfo.setFile("..\\input-files\\calibration_data_input_example.csv");
         QDir::setCurrent(fileInfo.path());
@@ -38,7 +122,7 @@ int main(int argc, char *argv[])
     }
     else
     {
-        fileInfo.setFile(QString(argv[1]));
+        fileInfo.setFile(inputFileName);
         QDir::setCurrent(fileInfo.path());
         file.setFileName(fileInfo.fileName());
         std::cout << "open the input file: " << qPrintable(fileInfo.absoluteFilePath()) << std::endl;
@@ -47,87 +131,204 @@ int main(int argc, char *argv[])
         std::cout << "Error: Program not able to open the input file. " << qPrintable(file.errorString()) << std::endl;
         return 1;
     }
-    QVector<float> refAngle;
-    QVector<float> measuredAngle;
-    QList<QByteArray> rowElement;
-    QByteArray line;
-    bool convserionOk;
-    //read header
-    line = file.readLine();
-    line.chop(2);
-    rowElement = line.split(',');
-    const size_t MAXWIDTH = 25;
-    std::cout << std::left << std::setw(MAXWIDTH*2+4) << std::setfill('-') << "-" << std::endl;
-    std::cout << " "  << std::left << std::setw(MAXWIDTH) << std::setfill(' ') << qPrintable(rowElement[0]) <<
-                 "| " << std::left << std::setw(MAXWIDTH) << std::setfill(' ') << qPrintable(rowElement[1]) << "|" << std::endl;
-    std::cout << std::left << std::setw(MAXWIDTH*2+4) << std::setfill('-') << "-" << std::endl;
-    //read the data
-    while (!file.atEnd()) {
-        line = file.readLine();
-        line.chop(2); //remove \r\n
-        rowElement = line.split(',');
-        refAngle.append(rowElement[0].toFloat(&convserionOk));
-        if (convserionOk == false)
-        {
-            std::cout << "Conversion Error! Not able to convert " << qPrintable(rowElement[0]) << " to float" << std::endl;
-        }
-        measuredAngle.append(rowElement[1].toFloat(&convserionOk));
-        if (convserionOk == false)
-        {
-            std::cout << "Conversion Error! Not able to convert " << qPrintable(rowElement[1]) << " to float" << std::endl;
-        }
-        std::cout << " "  << std::left << std::setw(MAXWIDTH) << std::setfill(' ') << qPrintable(rowElement[0]) <<
-                     "| " << std::left << std::setw(MAXWIDTH) << std::setfill(' ')<< qPrintable(rowElement[1]) << "|" << std::endl;
-    }
-    file.close();
-    const unsigned int dataLength = refAngle.size();
-    float referenceAngleArray[dataLength];
-    float measuredAngleArray[dataLength];
-
+    const uchar *mappedFile = file.map(0, file.size());
+    if (mappedFile == NULL)
+    {
+        std::cout << "Error: Program not able to map the input file. " << qPrintable(file.errorString()) << std::endl;
+        return 1;
+    }
     // The code below show an example on how to convert a raw angle value in degree
     float fullScaleValue = 360.0; //for example 512.0 is the full scale value for 9 bit data length (2^9)
-    for (unsigned int i = 0; i<dataLength;++i)
-    {
-        referenceAngleArray[i] = (float)refAngle[i]*360.0/fullScaleValue;
-        measuredAngleArray[i] = (float)measuredAngle[i]*360.0/fullScaleValue;
-    }
-    //Call Curve fitting function here
-    float h1;
-    float h2;
-    float h3;
-    float h4;
-    float phi1;
-    float phi2;
-    float phi3;
-    float phi4;
-    float angleErrorArray[dataLength];
-    // Find harmonics parameters
-    extractAngleErrorHarmonics(referenceAngleArray,
-                               measuredAngleArray,
-                               angleErrorArray,
-                               dataLength,
-                               &h1,
-                               &h2,
-                               &h3,
-                               &h4,
-                               &phi1,
-                               &phi2,
-                               &phi3,
-                               &phi4);
-    //Compute the fit for every measurement points (for test purpose)
-    float fittedAngleErrorInDegree[dataLength];
-    float angleErrorConstants[dataLength];
-    float angleErrorSlopes[dataLength];
-    generateAngleErrorLookupTableUsingFittedCurve( measuredAngleArray, fittedAngleErrorInDegree,
-                                    dataLength, &h1, &h2, &h3, &h4,
-                                    &phi1, &phi2, &phi3, &phi4);
-    generateAngleErrorLookupTableUsingConstantsAndSlopes( measuredAngleArray, angleErrorConstants, angleErrorSlopes,
-                                    dataLength, &h1, &h2, &h3, &h4,
-                                    &phi1, &phi2, &phi3, &phi4);
+    //Look for harmonics already extracted from the same capture with the same parameters
+    const unsigned int harmonicNumber = 4;
+    const QString cacheDirectory = "..\\cache-files";
+    QByteArray cacheKey;
+    CalibrationCacheEntry cacheEntry = CalibrationCacheEntry();
+    bool cacheHit = false;
+    if (useCache)
+    {
+        cacheKey = calibrationCacheKey(mappedFile, file.size(), harmonicNumber, fullScaleValue);
+        cacheHit = readCalibrationCache(cacheDirectory, cacheKey, &cacheEntry);
+        if (cacheHit)
+        {
+            std::cout << "Harmonics found in the cache: " << cacheKey.toHex().constData() << std::endl;
+        }
+    }
+    //Only one of the two sources is used: the parsed CSV columns or the raw pairs of the mapped binary capture
+    QVector<float> referenceAngleArray;
+    QVector<float> measuredAngleArray;
+    const unsigned short *rawAnglePairs = NULL;
+    unsigned int dataLength = cacheEntry.dataLength;
+    QVector<float> angleErrorArray;
+    float h1 = cacheEntry.h1;
+    float h2 = cacheEntry.h2;
+    float h3 = cacheEntry.h3;
+    float h4 = cacheEntry.h4;
+    float phi1 = cacheEntry.phi1;
+    float phi2 = cacheEntry.phi2;
+    float phi3 = cacheEntry.phi3;
+    float phi4 = cacheEntry.phi4;
+    //The samples are not needed when the lookup table is built from cached harmonics,
+    //on a cache hit they are only extracted for the angle error of calibration_curve.csv
+    if (!cacheHit || !lookupTableOnly)
+    {
+        if (isRawCapture(mappedFile, file.size()))
+        {
+            RawCaptureHeader header;
+            QString errorMessage;
+            if (!readRawCaptureHeader(mappedFile, file.size(), &header, &errorMessage))
+            {
+                std::cout << "Error: invalid raw capture file, " << qPrintable(errorMessage) << std::endl;
+                return 1;
+            }
+#if Q_BYTE_ORDER != Q_LITTLE_ENDIAN
+            std::cout << "Error: raw capture files are only supported on little-endian hosts." << std::endl;
+            return 1;
+#endif
+            if (!lookupTableOnly && header.sampleCount > REPORTMAXSAMPLECOUNT)
+            {
+                std::cout << "Error: the raw capture has " << header.sampleCount << " samples, calibration_curve.csv is limited to " <<
+                             REPORTMAXSAMPLECOUNT << " samples, use --lut-only" << std::endl;
+                return 1;
+            }
+            std::cout << "Raw capture: " << header.sampleCount << " samples, " << header.resolutionInBit << " bit, full scale " << header.fullScaleValue <<
+                         ", rig " << header.rigIdentifier.constData() << ", sensor " << header.sensorIdentifier.constData() << std::endl;
+            //the samples are used in place, straight from the mapped file
+            rawAnglePairs = reinterpret_cast<const unsigned short *>(mappedFile+header.headerSize);
+            dataLength = header.sampleCount;
+            fullScaleValue = header.fullScaleValue;
+        }
+        else
+        {
+            if (!loadCsvCapture(reinterpret_cast<const char *>(mappedFile), reinterpret_cast<const char *>(mappedFile)+file.size(),
+                                fullScaleValue, referenceAngleArray, measuredAngleArray, true))
+            {
+                return 1;
+            }
+            file.unmap(const_cast<uchar *>(mappedFile));
+            file.close();
+            dataLength = referenceAngleArray.size();
+        }
+        //the angle error is only needed for calibration_curve.csv
+        if (!lookupTableOnly)
+        {
+            angleErrorArray.resize(dataLength);
+        }
+        //Call Curve fitting function here
+        float *angleErrorOutput = lookupTableOnly ? NULL : angleErrorArray.data();
+        // Find harmonics parameters
+        unsigned char extractionStatus;
+        if (rawAnglePairs != NULL)
+        {
+            extractionStatus = extractAngleErrorHarmonicsFromRawData(rawAnglePairs,
+                                                                     (unsigned int)fullScaleValue,
+                                                                     angleErrorOutput,
+                                                                     dataLength,
+                                                                     &h1,
+                                                                     &h2,
+                                                                     &h3,
+                                                                     &h4,
+                                                                     &phi1,
+                                                                     &phi2,
+                                                                     &phi3,
+                                                                     &phi4);
+        }
+        else
+        {
+            extractionStatus = extractAngleErrorHarmonics(referenceAngleArray.data(),
+                                                          measuredAngleArray.data(),
+                                                          angleErrorOutput,
+                                                          dataLength,
+                                                          &h1,
+                                                          &h2,
+                                                          &h3,
+                                                          &h4,
+                                                          &phi1,
+                                                          &phi2,
+                                                          &phi3,
+                                                          &phi4);
+        }
+        if (extractionStatus != CALIBRATION_SUCCESS)
+        {
+            std::cout << "Error: harmonics extraction failed with error code " << (unsigned int)extractionStatus << std::endl;
+            return 1;
+        }
+        if (cacheHit)
+        {
+            //the extraction only provided the angle error of the report, the cached harmonics are kept
+            h1 = cacheEntry.h1;
+            h2 = cacheEntry.h2;
+            h3 = cacheEntry.h3;
+            h4 = cacheEntry.h4;
+            phi1 = cacheEntry.phi1;
+            phi2 = cacheEntry.phi2;
+            phi3 = cacheEntry.phi3;
+            phi4 = cacheEntry.phi4;
+        }
+        else if (useCache)
+        {
+            cacheEntry.dataLength = dataLength;
+            cacheEntry.h1 = h1;
+            cacheEntry.h2 = h2;
+            cacheEntry.h3 = h3;
+            cacheEntry.h4 = h4;
+            cacheEntry.phi1 = phi1;
+            cacheEntry.phi2 = phi2;
+            cacheEntry.phi3 = phi3;
+            cacheEntry.phi4 = phi4;
+            if (!writeCalibrationCache(cacheDirectory, cacheKey, cacheEntry))
+            {
+                std::cout << "Error, Program was unable to write the cache file in: " << qPrintable(cacheDirectory) << std::endl;
+            }
+        }
+    }
+    const float rawToDegree = 360.0/fullScaleValue;
+    if (benchmark)
+    {
+        runInterpolationBenchmark(&h1, &h2, &h3, &h4, &phi1, &phi2, &phi3, &phi4);
+    }
     //Generate the lookup table that will be use in the MCU application
     //Define the lookup table size
-    const unsigned int lookupTableSize = 32;
-    float lookupTableInputAngleArray[lookupTableSize];
+    unsigned int lookupTableSize = 32;
+    //model evaluations shared by all the candidate sizes and all the tables when the size is selected
+    QVector<float> denseAngleErrorArray;
+    QVector<float> denseAngleErrorSlopeArray;
+    if (maxInterpolationError > 0.0)
+    {
+        //pick the smallest table which meets the accuracy budget, all the sizes share the same model evaluations
+        const unsigned int lookupTableNumber = 5;
+        const unsigned int lookupTableSizes[lookupTableNumber] = {16, 32, 64, 128, 256};
+        const unsigned int denseSize = 16*lookupTableSizes[lookupTableNumber-1];
+        denseAngleErrorArray.resize(denseSize);
+        denseAngleErrorSlopeArray.resize(denseSize);
+        float maxInterpolationErrorArray[lookupTableNumber];
+        const unsigned char denseStatus = generateMultiResolutionAngleErrorLookupTables(denseAngleErrorArray.data(), denseAngleErrorSlopeArray.data(), denseSize,
+                                                                                        lookupTableSizes, maxInterpolationErrorArray, lookupTableNumber,
+                                                                                        &h1, &h2, &h3, &h4,
+                                                                                        &phi1, &phi2, &phi3, &phi4);
+        if (denseStatus != CALIBRATION_SUCCESS)
+        {
+            std::cout << "Error: dense lookup table generation failed with error code " << (unsigned int)denseStatus << std::endl;
+            return 1;
+        }
+        lookupTableSize = 0;
+        std::cout << "\n\nLookup Table Size Selection (maximum interpolation error " << maxInterpolationError << " degree)" << std::endl;
+        for (unsigned int i = 0; i<lookupTableNumber; ++i)
+        {
+            std::cout << "Size " << lookupTableSizes[i] << ": " << maxInterpolationErrorArray[i] << " degree" << std::endl;
+            if (lookupTableSize == 0 && maxInterpolationErrorArray[i] <= maxInterpolationError)
+            {
+                lookupTableSize = lookupTableSizes[i];
+            }
+        }
+        if (lookupTableSize == 0)
+        {
+            lookupTableSize = lookupTableSizes[lookupTableNumber-1];
+            std::cout << "Error: no lookup table size meets the maximum interpolation error, use the biggest one" << std::endl;
+        }
+        std::cout << "Selected lookup table size: " << lookupTableSize << std::endl;
+    }
+    QVector<float> lookupTableInputAngleArray(lookupTableSize);
     float angleStep = 360.0/(float)lookupTableSize;
     std::cout << "\n\nLookup Table Angle Error" <<std::endl;
     for(unsigned int i = 0;i<lookupTableSize;++i)
@@ -135,61 +336,44 @@ int main(int argc, char *argv[])
         lookupTableInputAngleArray[i]=(float)i*angleStep;
         std::cout << "Index[" << i << "] = " << lookupTableInputAngleArray[i] << std::endl;
     }
-    float lookupTableFittedOutputAngleArray[lookupTableSize];
-    generateAngleErrorLookupTableUsingFittedCurve(lookupTableInputAngleArray, lookupTableFittedOutputAngleArray,
-                                                  lookupTableSize, &h1, &h2, &h3, &h4,
-                                                  &phi1, &phi2, &phi3, &phi4);
-    float lookupTableConstOutputAngleArray[lookupTableSize];
-    float lookupTableSlopesOutputAngleArray[lookupTableSize];
-    generateAngleErrorLookupTableUsingConstantsAndSlopes(lookupTableInputAngleArray, lookupTableConstOutputAngleArray, lookupTableSlopesOutputAngleArray,
-                                                         lookupTableSize, &h1, &h2, &h3, &h4,
-                                                         &phi1, &phi2, &phi3, &phi4);
-    //Compute the interpolated points
-    float correctedAngleConstSlopes[dataLength];
-    float correctedAngleErrorConstSlopes[dataLength];
-    float angleError;
-
-    for(unsigned int i = 0;i<dataLength;++i)
-    {
-        correctedAngleConstSlopes[i]=interpolateAngleFromConstantsAndSlopes(measuredAngleArray[i],
-                                                                            lookupTableConstOutputAngleArray,
-                                                                            lookupTableSlopesOutputAngleArray,
-                                                                            lookupTableSize,
-                                                                            referenceAngleArray[0],
-                                                                            &angleError);
-        correctedAngleErrorConstSlopes[i]=angleError;
-    }
-    float correctedAngleConstSlopesLinSearch[dataLength];
-    float correctedAngleErrorConstSlopesLinSearch[dataLength];
-    for(unsigned int i = 0;i<dataLength;++i)
-    {
-        correctedAngleConstSlopesLinSearch[i]=interpolateAngleFromConstantsAndSlopesUsingLinearSearch(measuredAngleArray[i],
-                                                                                                      lookupTableInputAngleArray,
-                                                                                                      lookupTableConstOutputAngleArray,
-                                                                                                      lookupTableSlopesOutputAngleArray,
-                                                                                                      lookupTableSize,
-                                                                                                      referenceAngleArray[0],
-                                                                                                      &angleError);
-        correctedAngleErrorConstSlopesLinSearch[i]=angleError;
-    }
-    float correctedAngleFittedCurve[dataLength];
-    float correctedAngleErrorFittedCurve[dataLength];
-    for(unsigned int i = 0;i<dataLength;++i)
-    {
-        correctedAngleFittedCurve[i]=interpolateAngleFromFittedCurve(measuredAngleArray[i],
-                                                                     lookupTableInputAngleArray,
-                                                                     lookupTableFittedOutputAngleArray,
-                                                                     lookupTableSize,
-                                                                     referenceAngleArray[0],
-                                                                     &angleError);
-        correctedAngleErrorFittedCurve[i]=angleError;
-    }
-    float measuredAngleWithZeroCorrection[dataLength];
-    for(unsigned int i = 0;i<dataLength;++i)
-    {
-        measuredAngleWithZeroCorrection[i]=angleOutputWithoutCorrection(measuredAngleArray[i], referenceAngleArray[0]);
+    QVector<float> lookupTableFittedOutputAngleArray(lookupTableSize);
+    QVector<float> lookupTableConstOutputAngleArray(lookupTableSize);
+    QVector<float> lookupTableSlopesOutputAngleArray(lookupTableSize);
+    QVector<float> lookupTableCubicCoefficientArray(4*lookupTableSize);
+    if (!denseAngleErrorArray.isEmpty())
+    {
+        //the selected tables are subsamplings of the dense curve and slope, the model is not evaluated again
+        unsigned char subsamplingStatus = extractLookupTableFromDenseCurve(denseAngleErrorArray.data(), denseAngleErrorArray.size(),
+                                                                           lookupTableFittedOutputAngleArray.data(), lookupTableSize);
+        if (subsamplingStatus == CALIBRATION_SUCCESS)
+        {
+            subsamplingStatus = extractConstantsAndSlopesFromDenseCurve(denseAngleErrorArray.data(), denseAngleErrorArray.size(),
+                                                                        lookupTableConstOutputAngleArray.data(), lookupTableSlopesOutputAngleArray.data(),
+                                                                        lookupTableSize);
+        }
+        if (subsamplingStatus == CALIBRATION_SUCCESS)
+        {
+            subsamplingStatus = extractCubicCoefficientsFromDenseCurve(denseAngleErrorArray.data(), denseAngleErrorSlopeArray.data(), denseAngleErrorArray.size(),
+                                                                       lookupTableCubicCoefficientArray.data(), lookupTableSize);
+        }
+        if (subsamplingStatus != CALIBRATION_SUCCESS)
+        {
+            std::cout << "Error: lookup table subsampling failed with error code " << (unsigned int)subsamplingStatus << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        generateAngleErrorLookupTableUsingFittedCurve(lookupTableInputAngleArray.data(), lookupTableFittedOutputAngleArray.data(),
+                                                      lookupTableSize, &h1, &h2, &h3, &h4,
+                                                      &phi1, &phi2, &phi3, &phi4);
+        generateAngleErrorLookupTableUsingConstantsAndSlopes(lookupTableInputAngleArray.data(), lookupTableConstOutputAngleArray.data(), lookupTableSlopesOutputAngleArray.data(),
+                                                             lookupTableSize, &h1, &h2, &h3, &h4,
+                                                             &phi1, &phi2, &phi3, &phi4);
+        generateAngleErrorLookupTableUsingCubicCoefficients(lookupTableInputAngleArray.data(), lookupTableCubicCoefficientArray.data(),
+                                                            lookupTableSize, &h1, &h2, &h3, &h4,
+                                                            &phi1, &phi2, &phi3, &phi4);
     }
-    QFile outpuFile;
     QFileInfo outputFileInfo;
     outputFileInfo.setFile("..\\output-files\\calibration_curve.csv");
     QDir outputDir;
@@ -198,6 +382,26 @@ int main(int argc, char *argv[])
         std::cout << "Error, Program was unamble to create the directory: " << qPrintable(outputFileInfo.path()) << std::endl;
     }
     QDir::setCurrent(outputFileInfo.path());
+    QFile lookupTableFile("lookup_table.csv");
+    if(lookupTableFile.open(QFile::WriteOnly |QFile::Truncate))
+    {
+        QTextStream output(&lookupTableFile);
+        output << "Index" << "," << "Angle" << "," << "Angle Error Fitted" << "," << "Angle Error Constant" << "," << "Angle Error Slope" <<
+                  "," << "Cubic C0" << "," << "Cubic C1" << "," << "Cubic C2" << "," << "Cubic C3" << endl;
+        for (unsigned int i = 0; i<lookupTableSize;++i)
+        {
+            output << i << "," << lookupTableInputAngleArray[i] << "," << lookupTableFittedOutputAngleArray[i] << "," <<
+                      lookupTableConstOutputAngleArray[i] << "," << lookupTableSlopesOutputAngleArray[i] << "," <<
+                      lookupTableCubicCoefficientArray[4*i] << "," << lookupTableCubicCoefficientArray[4*i+1] << "," <<
+                      lookupTableCubicCoefficientArray[4*i+2] << "," << lookupTableCubicCoefficientArray[4*i+3] << endl;
+        }
+    }
+    lookupTableFile.close();
+    if (lookupTableOnly)
+    {
+        return 0;
+    }
+    QFile outpuFile;
     outpuFile.setFileName(outputFileInfo.fileName());
     if(outpuFile.open(QFile::WriteOnly |QFile::Truncate))
     {
@@ -210,15 +414,52 @@ int main(int argc, char *argv[])
                  "," << "Corrected Angle Cst + Slope Lin Search" << "," << "Angle Error after fit Cst + Slope Lin Search" <<
                  "," << "Corrected Angle Fitted" << "," << "Angle Error after Fit" <<
                  endl;
+        //Compute the fit and the interpolated points row by row while writing them
+        const float zeroDegreeOffset = (rawAnglePairs != NULL) ? (float)rawAnglePairs[0]*rawToDegree : referenceAngleArray[0];
+        float referenceAngle;
+        float measuredAngle;
+        float fittedAngleErrorInDegree;
+        float correctedAngleConstSlopes;
+        float correctedAngleErrorConstSlopes;
+        float correctedAngleConstSlopesLinSearch;
+        float correctedAngleErrorConstSlopesLinSearch;
+        float correctedAngleFittedCurve;
+        float correctedAngleErrorFittedCurve;
+        float measuredAngleWithZeroCorrection;
         for (unsigned int i = 0; i<dataLength;++i)
         {
-            output << referenceAngleArray[i] << "," << measuredAngleArray[i] << "," << measuredAngleWithZeroCorrection[i] << "," << angleErrorArray[i] << "," << fittedAngleErrorInDegree[i] << "," <<
+            referenceAngle = (rawAnglePairs != NULL) ? (float)rawAnglePairs[2*i]*rawToDegree : referenceAngleArray[i];
+            measuredAngle = (rawAnglePairs != NULL) ? (float)rawAnglePairs[2*i+1]*rawToDegree : measuredAngleArray[i];
+            generateAngleErrorLookupTableUsingFittedCurve(&measuredAngle, &fittedAngleErrorInDegree,
+                                                          1, &h1, &h2, &h3, &h4,
+                                                          &phi1, &phi2, &phi3, &phi4);
+            correctedAngleConstSlopes=interpolateAngleFromConstantsAndSlopes(measuredAngle,
+                                                                             lookupTableConstOutputAngleArray.data(),
+                                                                             lookupTableSlopesOutputAngleArray.data(),
+                                                                             lookupTableSize,
+                                                                             zeroDegreeOffset,
+                                                                             &correctedAngleErrorConstSlopes);
+            correctedAngleConstSlopesLinSearch=interpolateAngleFromConstantsAndSlopesUsingLinearSearch(measuredAngle,
+                                                                                                       lookupTableInputAngleArray.data(),
+                                                                                                       lookupTableConstOutputAngleArray.data(),
+                                                                                                       lookupTableSlopesOutputAngleArray.data(),
+                                                                                                       lookupTableSize,
+                                                                                                       zeroDegreeOffset,
+                                                                                                       &correctedAngleErrorConstSlopesLinSearch);
+            correctedAngleFittedCurve=interpolateAngleFromFittedCurve(measuredAngle,
+                                                                      lookupTableInputAngleArray.data(),
+                                                                      lookupTableFittedOutputAngleArray.data(),
+                                                                      lookupTableSize,
+                                                                      zeroDegreeOffset,
+                                                                      &correctedAngleErrorFittedCurve);
+            measuredAngleWithZeroCorrection=angleOutputWithoutCorrection(measuredAngle, zeroDegreeOffset);
+            output << referenceAngle << "," << measuredAngle << "," << measuredAngleWithZeroCorrection << "," << angleErrorArray[i] << "," << fittedAngleErrorInDegree << "," <<
                       h1 << "," << h2 << "," << h3 << "," << h4 << "," <<
-                      phi2 << "," << phi2 << "," << phi2 << "," << phi2 << "," <<
+                      phi1 << "," << phi2 << "," << phi3 << "," << phi4 << "," <<
                       dataLength<< "," <<
-                      correctedAngleConstSlopes[i] << "," << correctedAngleErrorConstSlopes[i] <<"," <<
-                      correctedAngleConstSlopesLinSearch[i] << "," << correctedAngleErrorConstSlopesLinSearch[i] <<"," <<
-                      correctedAngleFittedCurve[i] << "," << correctedAngleErrorFittedCurve[i] <<
+                      correctedAngleConstSlopes << "," << correctedAngleErrorConstSlopes <<"," <<
+                      correctedAngleConstSlopesLinSearch << "," << correctedAngleErrorConstSlopesLinSearch <<"," <<
+                      correctedAngleFittedCurve << "," << correctedAngleErrorFittedCurve <<
                       endl;
         }
     }
@@ -0,0 +1,69 @@
+#include "rawcapture.h"
+
+#include <QtEndian>
+
+#include <cstring>
+
+static QByteArray readIdentifier(const uchar *data, int maxSize)
+{
+    const char *identifier = reinterpret_cast<const char *>(data);
+    int size = 0;
+    while (size < maxSize && identifier[size] != '\0')
+    {
+        ++size;
+    }
+    return QByteArray(identifier, size);
+}
+
+bool isRawCapture(const uchar *data, qint64 size)
+{
+    return (size >= (qint64)sizeof(RAWCAPTUREMAGIC)) && (memcmp(data, RAWCAPTUREMAGIC, sizeof(RAWCAPTUREMAGIC)) == 0);
+}
+
+bool readRawCaptureHeader(const uchar *data, qint64 size, RawCaptureHeader *pHeader, QString *pErrorMessage)
+{
+    if (size < (qint64)RAWCAPTUREMINHEADERSIZE || !isRawCapture(data, size))
+    {
+        *pErrorMessage = "not a raw capture file";
+        return false;
+    }
+    pHeader->version = qFromLittleEndian<quint16>(data+4);
+    pHeader->headerSize = qFromLittleEndian<quint16>(data+6);
+    pHeader->resolutionInBit = qFromLittleEndian<quint16>(data+8);
+    pHeader->fullScaleValue = qFromLittleEndian<quint32>(data+12);
+    pHeader->sampleCount = qFromLittleEndian<quint64>(data+16);
+    pHeader->captureTime = qFromLittleEndian<quint64>(data+24);
+    pHeader->rigIdentifier = readIdentifier(data+32, 16);
+    pHeader->sensorIdentifier = readIdentifier(data+48, 16);
+    if (pHeader->version != RAWCAPTUREVERSION)
+    {
+        *pErrorMessage = QString("unsupported format version %1").arg(pHeader->version);
+        return false;
+    }
+    if (pHeader->headerSize < RAWCAPTUREMINHEADERSIZE || (pHeader->headerSize % 2) != 0)
+    {
+        *pErrorMessage = QString("invalid header size %1").arg(pHeader->headerSize);
+        return false;
+    }
+    if (pHeader->fullScaleValue == 0 || pHeader->fullScaleValue > 65536)
+    {
+        *pErrorMessage = QString("invalid full scale value %1").arg(pHeader->fullScaleValue);
+        return false;
+    }
+    if (pHeader->resolutionInBit == 0 || pHeader->resolutionInBit > 16 || pHeader->fullScaleValue > (1u << pHeader->resolutionInBit))
+    {
+        *pErrorMessage = QString("full scale value %1 does not fit in %2 bit codes").arg(pHeader->fullScaleValue).arg(pHeader->resolutionInBit);
+        return false;
+    }
+    if (pHeader->sampleCount == 0 || pHeader->sampleCount > RAWCAPTUREMAXSAMPLECOUNT)
+    {
+        *pErrorMessage = QString("invalid sample count %1, at most %2 samples are supported").arg(pHeader->sampleCount).arg(RAWCAPTUREMAXSAMPLECOUNT);
+        return false;
+    }
+    if ((qint64)pHeader->headerSize > size || (quint64)(size-pHeader->headerSize) < pHeader->sampleCount*4)
+    {
+        *pErrorMessage = QString("file truncated, %1 samples expected").arg(pHeader->sampleCount);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,95 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Mathieu Kaelin for Monolithic Power Systems
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+#ifndef RAWCAPTURE_H
+#define RAWCAPTURE_H
+
+#include <QByteArray>
+#include <QString>
+
+/**
+ * @file rawcapture.h
+ * @brief Binary raw sample capture format.
+ *
+ * A raw capture file is made of a header followed by the packed samples.
+ * All the fields are little-endian.
+ *
+ * | Offset | Type        | Field                                             |
+ * | :----- | :---------- | :------------------------------------------------ |
+ * | 0      | char[4]     | Magic "MACB"                                      |
+ * | 4      | uint16      | Format version (1)                                |
+ * | 6      | uint16      | Header size in byte (even, at least 64)           |
+ * | 8      | uint16      | Resolution in bit                                 |
+ * | 10     | uint16      | Reserved (0)                                      |
+ * | 12     | uint32      | Full scale value, number of codes per turn        |
+ * | 16     | uint64      | Sample count                                      |
+ * | 24     | uint64      | Capture time in seconds since 1970-01-01 UTC      |
+ * | 32     | char[16]    | Calibration rig identifier (zero padded)          |
+ * | 48     | char[16]    | Sensor identifier (zero padded)                   |
+ *
+ * The data section starts at the header size offset and contains
+ * sample count pairs of uint16 (reference code, sensor code).
+ * The full scale value must fit in the resolution (at most 2^resolution),
+ * every code must be smaller than the full scale value and the sample count
+ * is limited to 2^31-1.
+ */
+
+static const char RAWCAPTUREMAGIC[4] = {'M', 'A', 'C', 'B'};
+static const unsigned int RAWCAPTUREVERSION = 1;
+static const unsigned int RAWCAPTUREMINHEADERSIZE = 64;
+//the pairs are indexed with 2*i on unsigned int, which must not wrap
+static const quint64 RAWCAPTUREMAXSAMPLECOUNT = 0x7FFFFFFF;
+
+struct RawCaptureHeader
+{
+    unsigned int version;
+    unsigned int headerSize;
+    unsigned int resolutionInBit;
+    unsigned int fullScaleValue;
+    quint64 sampleCount;
+    quint64 captureTime;
+    QByteArray rigIdentifier;
+    QByteArray sensorIdentifier;
+};
+
+/**
+ * @brief Check if the data starts with the raw capture magic.
+ *
+ * @param data Beginning of the file content
+ * @param size Size of the file content in byte
+ * @return true for a raw capture file
+ */
+bool isRawCapture(const uchar *data, qint64 size);
+
+/**
+ * @brief Decode and validate the header of a raw capture file.
+ *
+ * @param data Beginning of the file content
+ * @param size Size of the file content in byte
+ * @param pHeader Decoded header
+ * @param pErrorMessage Reason of the failure
+ * @return true if the header is valid and the file contains all the samples
+ */
+bool readRawCaptureHeader(const uchar *data, qint64 size, RawCaptureHeader *pHeader, QString *pErrorMessage);
+
+#endif // RAWCAPTURE_H
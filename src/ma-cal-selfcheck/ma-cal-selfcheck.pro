@@ -0,0 +1,30 @@
+QT += core concurrent network
+QT -= gui
+
+CONFIG += c++11
+
+TARGET = ma-cal-selfcheck
+DESTDIR = "../../bin"
+CONFIG += console
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+INCLUDEPATH += \
+    ../calibration-curve-generator \
+    ../angle-interpolation \
+    ../ma-cal-generator
+
+SOURCES += main.cpp \
+    selfcheck.cpp \
+    ../ma-cal-generator/csvcapture.cpp \
+    ../ma-cal-generator/calibrationserver.cpp \
+    ../calibration-curve-generator/calibrationcurvegenerator.c \
+    ../angle-interpolation/angleinterpolation.c
+
+HEADERS += \
+    selfcheck.h \
+    ../ma-cal-generator/csvcapture.h \
+    ../ma-cal-generator/calibrationserver.h \
+    ../calibration-curve-generator/calibrationcurvegenerator.h \
+    ../angle-interpolation/angleinterpolation.h
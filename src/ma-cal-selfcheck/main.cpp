@@ -0,0 +1,37 @@
+#include <QCoreApplication>
+#include <QString>
+
+#include <iostream>
+
+#include "selfcheck.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+    unsigned int maxSampleNumber = 1000000;
+    for (int i = 1; i < argc; ++i)
+    {
+        const QString argument = QString::fromLocal8Bit(argv[i]);
+        if (argument == "--max-size")
+        {
+            if (i+1 >= argc)
+            {
+                std::cout << "Error: missing value for " << argv[i] << std::endl;
+                return 1;
+            }
+            bool conversionOk;
+            maxSampleNumber = QString::fromLocal8Bit(argv[++i]).toUInt(&conversionOk);
+            if (conversionOk == false || maxSampleNumber < 200)
+            {
+                std::cout << "Error: invalid maximum size " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else
+        {
+            std::cout << "Error: unknown option " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+    return runSelfCheck(maxSampleNumber) ? 0 : 1;
+}
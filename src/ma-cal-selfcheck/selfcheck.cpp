@@ -0,0 +1,793 @@
+#include "selfcheck.h"
+
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QFutureWatcher>
+#include <QLocalSocket>
+#include <QSharedMemory>
+#include <QString>
+#include <QVector>
+#include <QtConcurrent>
+#include <QtEndian>
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#include "calibrationcurvegenerator.h"
+#include "angleinterpolation.h"
+#include "csvcapture.h"
+#include "calibrationserver.h"
+
+static const float SYNTHETICH[CALIBRATION_HARMONIC_NUMBER] = {0.8, 3.4, 0.3, 1.6};
+static const float SYNTHETICPHI[CALIBRATION_HARMONIC_NUMBER] = {-1.5, 0.3, 1.0, 2.0};
+static const float SYNTHETICSTARTANGLE = 258.0;
+static const float SYNTHETICNOISE = 0.05;
+static const unsigned int RAWFULLSCALEVALUE = 65536;
+static const unsigned int FUZZITERATIONNUMBER = 2000;
+static const unsigned int SERVERSAMPLERINGSIZE = 1 << 16;
+static const unsigned int SERVERSAMPLENUMBER = 5000;
+static const unsigned int SERVERRINGOFFSET = 1000;
+//the request starts 2000 samples before the end of the ring and wraps around
+static const unsigned int SERVERWRAPPEDRINGOFFSET = SERVERSAMPLERINGSIZE-2000;
+static const unsigned int SERVERLOOKUPTABLESIZE = 32;
+static const int SERVERTIMEOUT = 5000;
+//harmonics (degree and radian) and centered angle error of the library against the double reference
+static const float REFERENCETOLERANCE = 1e-4;
+
+struct Harmonics
+{
+    float h[CALIBRATION_HARMONIC_NUMBER];
+    float phi[CALIBRATION_HARMONIC_NUMBER];
+};
+
+struct ServerResponse
+{
+    quint32 status;
+    quint32 sampleCount;
+    quint32 lookupTableSize;
+    Harmonics harmonics;
+    QVector<float> lookupTables;    //fitted, constants, slopes then cubic coefficients
+};
+
+//deterministic pseudo random generator, the same seed always gives the same capture
+static quint32 nextRandom(quint32 *pSeed)
+{
+    *pSeed = (*pSeed)*1664525u+1013904223u;
+    return *pSeed;
+}
+
+static float uniformRandom(quint32 *pSeed)
+{
+    return (float)(nextRandom(pSeed) >> 8)/16777216.0;
+}
+
+static float modulo(float x, float y)
+{
+    float b = fmodf(x,y);
+    return b < 0 ? b + y : b;
+}
+
+static float phaseDifference(float phi1, float phi2)
+{
+    //computed in double so equal phases give exactly 0
+    double difference = fmod((double)phi1-(double)phi2+M_PI, 2.0*M_PI);
+    if (difference < 0)
+    {
+        difference += 2.0*M_PI;
+    }
+    return fabs(difference-M_PI);
+}
+
+static bool report(bool passed, const QString &name, float deviation)
+{
+    std::cout << (passed ? "PASS " : "FAIL ") << qPrintable(name) << " (deviation " << deviation << ")" << std::endl;
+    return passed;
+}
+
+static void generateSyntheticCapture(unsigned int sampleNumber,
+                                     float angleErrorOffset,
+                                     quint32 seed,
+                                     QVector<float> &referenceAngleArray,
+                                     QVector<float> &measuredAngleArray)
+{
+    referenceAngleArray.resize(sampleNumber);
+    measuredAngleArray.resize(sampleNumber);
+    for (unsigned int i = 0; i < sampleNumber; ++i)
+    {
+        //the reference angle starts away from zero, so it wraps around 360 degree in the capture
+        const double angleRadian = 2.0*M_PI*(double)i/(double)sampleNumber;
+        double angleError = angleErrorOffset+SYNTHETICNOISE*(2.0*uniformRandom(&seed)-1.0);
+        for (unsigned int k = 0; k < CALIBRATION_HARMONIC_NUMBER; ++k)
+        {
+            angleError += SYNTHETICH[k]*cos((k+1)*angleRadian-SYNTHETICPHI[k]);
+        }
+        referenceAngleArray[i] = modulo(SYNTHETICSTARTANGLE+angleRadian*180.0/M_PI, 360.0);
+        measuredAngleArray[i] = modulo(referenceAngleArray[i]+angleError, 360.0);
+    }
+}
+
+static unsigned char extract(QVector<float> &referenceAngleArray, QVector<float> &measuredAngleArray, Harmonics *pHarmonics)
+{
+    QVector<float> angleErrorArray(referenceAngleArray.size());
+    return extractAngleErrorHarmonics(referenceAngleArray.data(), measuredAngleArray.data(), angleErrorArray.data(), referenceAngleArray.size(),
+                                      &pHarmonics->h[0], &pHarmonics->h[1], &pHarmonics->h[2], &pHarmonics->h[3],
+                                      &pHarmonics->phi[0], &pHarmonics->phi[1], &pHarmonics->phi[2], &pHarmonics->phi[3]);
+}
+
+static float harmonicsDeviation(const Harmonics &a, const Harmonics &b)
+{
+    float deviation = 0.0;
+    for (unsigned int k = 0; k < CALIBRATION_HARMONIC_NUMBER; ++k)
+    {
+        deviation = qMax(deviation, fabsf(a.h[k]-b.h[k]));
+        //the phase of a negligible harmonic is meaningless
+        if (qMin(a.h[k], b.h[k]) > 0.1)
+        {
+            deviation = qMax(deviation, phaseDifference(a.phi[k], b.phi[k]));
+        }
+    }
+    return deviation;
+}
+
+//Straightforward multi-pass extraction in double, the reference of the single pass library kernel:
+//jump count, 180 degree shift if needed, mean subtraction then one pass per harmonic.
+static void extractReferenceHarmonics(const QVector<double> &angleErrorArray, Harmonics *pHarmonics, QVector<double> &centeredAngleErrorArray)
+{
+    const int size = angleErrorArray.size();
+    centeredAngleErrorArray = angleErrorArray;
+    int jumpNumber = 0;
+    for (int i = 0; i < size; ++i)
+    {
+        if (fabs(angleErrorArray[i]-angleErrorArray[(i+size-1)%size]) > 180.0)
+        {
+            ++jumpNumber;
+        }
+    }
+    if (jumpNumber > 0)
+    {
+        for (int i = 0; i < size; ++i)
+        {
+            centeredAngleErrorArray[i] = fmod(angleErrorArray[i]+180.0, 360.0);
+        }
+    }
+    double meanAngleError = 0.0;
+    for (int i = 0; i < size; ++i)
+    {
+        meanAngleError += centeredAngleErrorArray[i];
+    }
+    meanAngleError /= (double)size;
+    for (int i = 0; i < size; ++i)
+    {
+        centeredAngleErrorArray[i] -= meanAngleError;
+    }
+    for (unsigned int k = 0; k < CALIBRATION_HARMONIC_NUMBER; ++k)
+    {
+        double sumCos = 0.0;
+        double sumSin = 0.0;
+        for (int i = 0; i < size; ++i)
+        {
+            const double angleRadian = (double)(k+1)*2.0*M_PI*(double)i/(double)size;
+            sumCos += centeredAngleErrorArray[i]*cos(angleRadian);
+            sumSin += centeredAngleErrorArray[i]*sin(angleRadian);
+        }
+        const double x = (2.0/(double)size)*sumCos;
+        const double y = (2.0/(double)size)*sumSin;
+        pHarmonics->h[k] = sqrt(x*x+y*y);
+        pHarmonics->phi[k] = atan2(y, x);
+    }
+}
+
+//worst deviation of the harmonics and of the centered angle error from the reference
+static float referenceDeviation(const QVector<double> &angleErrorArray, const Harmonics &harmonics, const QVector<float> &centeredAngleErrorArray)
+{
+    Harmonics referenceHarmonics;
+    QVector<double> referenceCenteredAngleErrorArray;
+    extractReferenceHarmonics(angleErrorArray, &referenceHarmonics, referenceCenteredAngleErrorArray);
+    float deviation = harmonicsDeviation(referenceHarmonics, harmonics);
+    for (int i = 0; i < centeredAngleErrorArray.size(); ++i)
+    {
+        deviation = qMax(deviation, (float)fabs(centeredAngleErrorArray[i]-referenceCenteredAngleErrorArray[i]));
+    }
+    return deviation;
+}
+
+static bool checkExtraction(unsigned int sampleNumber, float angleErrorOffset)
+{
+    QVector<float> referenceAngleArray;
+    QVector<float> measuredAngleArray;
+    generateSyntheticCapture(sampleNumber, angleErrorOffset, sampleNumber, referenceAngleArray, measuredAngleArray);
+    Harmonics expected;
+    Harmonics extracted;
+    for (unsigned int k = 0; k < CALIBRATION_HARMONIC_NUMBER; ++k)
+    {
+        //the phases are relative to the first sample
+        expected.h[k] = SYNTHETICH[k];
+        expected.phi[k] = SYNTHETICPHI[k];
+    }
+    QVector<float> angleErrorArray(sampleNumber);
+    const bool extractionOk = extractAngleErrorHarmonics(referenceAngleArray.data(), measuredAngleArray.data(), angleErrorArray.data(), sampleNumber,
+                                                         &extracted.h[0], &extracted.h[1], &extracted.h[2], &extracted.h[3],
+                                                         &extracted.phi[0], &extracted.phi[1], &extracted.phi[2], &extracted.phi[3]) == CALIBRATION_SUCCESS;
+    //without angle error output the harmonics must be exactly the same
+    Harmonics withoutAngleError;
+    const bool withoutAngleErrorOk = extractAngleErrorHarmonics(referenceAngleArray.data(), measuredAngleArray.data(), NULL, sampleNumber,
+                                                                &withoutAngleError.h[0], &withoutAngleError.h[1], &withoutAngleError.h[2], &withoutAngleError.h[3],
+                                                                &withoutAngleError.phi[0], &withoutAngleError.phi[1], &withoutAngleError.phi[2], &withoutAngleError.phi[3]) == CALIBRATION_SUCCESS &&
+                                     harmonicsDeviation(extracted, withoutAngleError) == 0.0;
+    const float deviation = withoutAngleErrorOk ? harmonicsDeviation(expected, extracted) : INFINITY;
+    bool passed = report(extractionOk && deviation < 0.02,
+                         QString("extraction against the known harmonics, %1 samples, offset %2 degree").arg(sampleNumber).arg(angleErrorOffset), deviation);
+    QVector<double> wrappedAngleErrorArray(sampleNumber);
+    for (unsigned int i = 0; i < sampleNumber; ++i)
+    {
+        wrappedAngleErrorArray[i] = fmod((double)measuredAngleArray[i]-(double)referenceAngleArray[i]+360.0, 360.0);
+    }
+    const float kernelDeviation = referenceDeviation(wrappedAngleErrorArray, extracted, angleErrorArray);
+    passed = report(extractionOk && kernelDeviation < REFERENCETOLERANCE,
+                    QString("extraction against the reference, %1 samples, offset %2 degree").arg(sampleNumber).arg(angleErrorOffset), kernelDeviation) && passed;
+    return passed;
+}
+
+static bool checkRawData(unsigned int sampleNumber, float angleErrorOffset)
+{
+    QVector<float> referenceAngleArray;
+    QVector<float> measuredAngleArray;
+    generateSyntheticCapture(sampleNumber, angleErrorOffset, sampleNumber+1, referenceAngleArray, measuredAngleArray);
+    QVector<unsigned short> rawAnglePairs(2*sampleNumber);
+    QVector<double> wrappedAngleErrorArray(sampleNumber);
+    const double rawToDegree = 360.0/(double)RAWFULLSCALEVALUE;
+    for (unsigned int i = 0; i < sampleNumber; ++i)
+    {
+        rawAnglePairs[2*i] = (unsigned int)lround(referenceAngleArray[i]/rawToDegree)%RAWFULLSCALEVALUE;
+        rawAnglePairs[2*i+1] = (unsigned int)lround(measuredAngleArray[i]/rawToDegree)%RAWFULLSCALEVALUE;
+        wrappedAngleErrorArray[i] = (double)((rawAnglePairs[2*i+1]+RAWFULLSCALEVALUE-rawAnglePairs[2*i])%RAWFULLSCALEVALUE)*rawToDegree;
+    }
+    Harmonics raw;
+    QVector<float> angleErrorArray(sampleNumber);
+    const bool extractionOk = extractAngleErrorHarmonicsFromRawData(rawAnglePairs.constData(), RAWFULLSCALEVALUE, angleErrorArray.data(), sampleNumber,
+                                                                    &raw.h[0], &raw.h[1], &raw.h[2], &raw.h[3],
+                                                                    &raw.phi[0], &raw.phi[1], &raw.phi[2], &raw.phi[3]) == CALIBRATION_SUCCESS;
+    const float deviation = referenceDeviation(wrappedAngleErrorArray, raw, angleErrorArray);
+    return report(extractionOk && deviation < REFERENCETOLERANCE,
+                  QString("raw codes against the reference, %1 samples, offset %2 degree").arg(sampleNumber).arg(angleErrorOffset), deviation);
+}
+
+static bool checkContext(unsigned int sampleNumber)
+{
+    QVector<float> referenceAngleArray;
+    QVector<float> measuredAngleArray;
+    generateSyntheticCapture(sampleNumber, 0.5, sampleNumber+2, referenceAngleArray, measuredAngleArray);
+    Harmonics reference;
+    extract(referenceAngleArray, measuredAngleArray, &reference);
+    QVector<float> scratchBuffer(sampleNumber);
+    magalpha_calib_ctx context;
+    bool passed = (calibrationContextInit(&context, scratchBuffer.data(), sampleNumber) == CALIBRATION_SUCCESS);
+    //a computation bigger than the scratch buffer must be rejected, not overflow it
+    passed = passed && (calibrationContextCompute(&context, referenceAngleArray.data(), measuredAngleArray.data(), sampleNumber+1) == CALIBRATION_ERROR_BUFFER_TOO_SMALL);
+    passed = passed && (calibrationContextCompute(&context, referenceAngleArray.data(), measuredAngleArray.data(), 0) == CALIBRATION_ERROR_INVALID_SIZE);
+    passed = passed && (calibrationContextCompute(&context, referenceAngleArray.data(), measuredAngleArray.data(), sampleNumber) == CALIBRATION_SUCCESS);
+    Harmonics contextHarmonics;
+    for (unsigned int k = 0; k < CALIBRATION_HARMONIC_NUMBER; ++k)
+    {
+        contextHarmonics.h[k] = context.h[k];
+        contextHarmonics.phi[k] = context.phi[k];
+    }
+    calibrationContextDestroy(&context);
+    const float deviation = harmonicsDeviation(reference, contextHarmonics);
+    return report(passed && deviation == 0.0, QString("calibration context, %1 samples").arg(sampleNumber), deviation);
+}
+
+static bool checkLookupTables(unsigned int lookupTableSize)
+{
+    Harmonics harmonics;
+    for (unsigned int k = 0; k < CALIBRATION_HARMONIC_NUMBER; ++k)
+    {
+        harmonics.h[k] = SYNTHETICH[k];
+        harmonics.phi[k] = SYNTHETICPHI[k];
+    }
+    QVector<float> lookupTableAngleArray(lookupTableSize);
+    for (unsigned int i = 0; i < lookupTableSize; ++i)
+    {
+        lookupTableAngleArray[i] = (float)i*360.0/(float)lookupTableSize;
+    }
+    QVector<float> fittedArray(lookupTableSize);
+    generateAngleErrorLookupTableUsingFittedCurve(lookupTableAngleArray.data(), fittedArray.data(), lookupTableSize,
+                                                  &harmonics.h[0], &harmonics.h[1], &harmonics.h[2], &harmonics.h[3],
+                                                  &harmonics.phi[0], &harmonics.phi[1], &harmonics.phi[2], &harmonics.phi[3]);
+    QVector<float> constantArray(lookupTableSize);
+    QVector<float> slopeArray(lookupTableSize);
+    generateAngleErrorLookupTableUsingConstantsAndSlopes(lookupTableAngleArray.data(), constantArray.data(), slopeArray.data(), lookupTableSize,
+                                                         &harmonics.h[0], &harmonics.h[1], &harmonics.h[2], &harmonics.h[3],
+                                                         &harmonics.phi[0], &harmonics.phi[1], &harmonics.phi[2], &harmonics.phi[3]);
+    QVector<float> cubicCoefficientArray(4*lookupTableSize);
+    generateAngleErrorLookupTableUsingCubicCoefficients(lookupTableAngleArray.data(), cubicCoefficientArray.data(), lookupTableSize,
+                                                        &harmonics.h[0], &harmonics.h[1], &harmonics.h[2], &harmonics.h[3],
+                                                        &harmonics.phi[0], &harmonics.phi[1], &harmonics.phi[2], &harmonics.phi[3]);
+    //tables subsampled from the dense curve and slope against the direct generation
+    const unsigned int denseSize = 16*lookupTableSize;
+    QVector<float> denseArray(denseSize);
+    QVector<float> denseSlopeArray(denseSize);
+    float maxInterpolationError;
+    QVector<float> extractedArray(lookupTableSize);
+    QVector<float> extractedConstantArray(lookupTableSize);
+    QVector<float> extractedSlopeArray(lookupTableSize);
+    QVector<float> extractedCubicCoefficientArray(4*lookupTableSize);
+    const bool denseOk = generateMultiResolutionAngleErrorLookupTables(denseArray.data(), denseSlopeArray.data(), denseSize, &lookupTableSize, &maxInterpolationError, 1,
+                                                                       &harmonics.h[0], &harmonics.h[1], &harmonics.h[2], &harmonics.h[3],
+                                                                       &harmonics.phi[0], &harmonics.phi[1], &harmonics.phi[2], &harmonics.phi[3]) == CALIBRATION_SUCCESS &&
+                         extractLookupTableFromDenseCurve(denseArray.data(), denseSize, extractedArray.data(), lookupTableSize) == CALIBRATION_SUCCESS &&
+                         extractConstantsAndSlopesFromDenseCurve(denseArray.data(), denseSize, extractedConstantArray.data(), extractedSlopeArray.data(),
+                                                                 lookupTableSize) == CALIBRATION_SUCCESS &&
+                         extractCubicCoefficientsFromDenseCurve(denseArray.data(), denseSlopeArray.data(), denseSize, extractedCubicCoefficientArray.data(),
+                                                                lookupTableSize) == CALIBRATION_SUCCESS;
+    float denseDeviation = denseOk ? 0.0 : INFINITY;
+    for (unsigned int i = 0; denseOk && i < lookupTableSize; ++i)
+    {
+        denseDeviation = qMax(denseDeviation, fabsf(extractedArray[i]-fittedArray[i]));
+        denseDeviation = qMax(denseDeviation, fabsf(extractedConstantArray[i]-constantArray[i]));
+        denseDeviation = qMax(denseDeviation, fabsf(extractedSlopeArray[i]-slopeArray[i]));
+        for (unsigned int j = 0; j < 4; ++j)
+        {
+            denseDeviation = qMax(denseDeviation, fabsf(extractedCubicCoefficientArray[4*i+j]-cubicCoefficientArray[4*i+j]));
+        }
+    }
+    bool passed = report(denseOk && denseDeviation < 1e-4, QString("dense lookup tables, %1 entries").arg(lookupTableSize), denseDeviation);
+    //cubic batch interpolation against the scalar one, including angles outside of [0, 360[
+    const unsigned int angleNumber = 10000;
+    QVector<float> angleArray(angleNumber);
+    quint32 seed = lookupTableSize;
+    for (unsigned int i = 0; i < angleNumber; ++i)
+    {
+        angleArray[i] = 1080.0*uniformRandom(&seed)-360.0;
+    }
+    QVector<float> correctedAngleArray(angleNumber);
+    QVector<float> angleErrorArray(angleNumber);
+    interpolateAngleArrayFromCubicCoefficients(angleArray.data(), correctedAngleArray.data(), angleErrorArray.data(), angleNumber,
+                                               cubicCoefficientArray.data(), lookupTableSize, 0.0);
+    float batchDeviation = 0.0;
+    float cubicError = 0.0;
+    float angleError;
+    float fittedAngleError;
+    for (unsigned int i = 0; i < angleNumber; ++i)
+    {
+        const float correctedAngle = interpolateAngleFromCubicCoefficients(angleArray[i], cubicCoefficientArray.data(), lookupTableSize, 0.0, &angleError);
+        batchDeviation = qMax(batchDeviation, fabsf(correctedAngle-correctedAngleArray[i]));
+        batchDeviation = qMax(batchDeviation, fabsf(angleError-angleErrorArray[i]));
+        generateAngleErrorLookupTableUsingFittedCurve(&angleArray[i], &fittedAngleError, 1,
+                                                      &harmonics.h[0], &harmonics.h[1], &harmonics.h[2], &harmonics.h[3],
+                                                      &harmonics.phi[0], &harmonics.phi[1], &harmonics.phi[2], &harmonics.phi[3]);
+        cubicError = qMax(cubicError, fabsf(angleError-fittedAngleError));
+    }
+    passed = report(batchDeviation == 0.0, QString("cubic batch interpolation, %1 entries").arg(lookupTableSize), batchDeviation) && passed;
+    //a cubic table must be at least as accurate as a linear table of the same size
+    passed = report(denseOk && (lookupTableSize < 8 || cubicError <= maxInterpolationError),
+                    QString("cubic accuracy, %1 entries").arg(lookupTableSize), cubicError) && passed;
+    return passed;
+}
+
+static QByteArray writeCsv(const QVector<float> &referenceAngleArray, const QVector<float> &measuredAngleArray, const char *lineEnd)
+{
+    QByteArray csv = "Reference Angle [degree],Measured Angle [degree]";
+    csv.append(lineEnd);
+    for (int i = 0; i < referenceAngleArray.size(); ++i)
+    {
+        csv.append(QByteArray::number(referenceAngleArray[i], 'g', 9));
+        csv.append(',');
+        csv.append(QByteArray::number(measuredAngleArray[i], 'g', 9));
+        csv.append(lineEnd);
+        //blank lines must be skipped
+        if (i%1000 == 999)
+        {
+            csv.append(lineEnd);
+        }
+    }
+    return csv;
+}
+
+static bool checkCsvParser(unsigned int sampleNumber, const char *lineEnd)
+{
+    QVector<float> referenceAngleArray;
+    QVector<float> measuredAngleArray;
+    generateSyntheticCapture(sampleNumber, 75.0, sampleNumber+3, referenceAngleArray, measuredAngleArray);
+    const QByteArray csv = writeCsv(referenceAngleArray, measuredAngleArray, lineEnd);
+    QVector<float> parsedReferenceAngleArray;
+    QVector<float> parsedMeasuredAngleArray;
+    bool passed = loadCsvCapture(csv.constData(), csv.constData()+csv.size(), 360.0, parsedReferenceAngleArray, parsedMeasuredAngleArray, false);
+    passed = passed && (parsedReferenceAngleArray.size() == (int)sampleNumber) && (parsedMeasuredAngleArray.size() == (int)sampleNumber);
+    float deviation = 0.0;
+    for (int i = 0; passed && i < (int)sampleNumber; ++i)
+    {
+        deviation = qMax(deviation, fabsf(parsedReferenceAngleArray[i]-referenceAngleArray[i]));
+        deviation = qMax(deviation, fabsf(parsedMeasuredAngleArray[i]-measuredAngleArray[i]));
+    }
+    return report(passed && deviation == 0.0, QString("parallel CSV parser, %1 rows").arg(sampleNumber), deviation);
+}
+
+//independent of the parser: a line is a row as soon as it holds a non whitespace character
+static int nonBlankLineNumber(const QByteArray &text)
+{
+    int lineNumber = 0;
+    const QList<QByteArray> lines = text.split('\n');
+    for (int i = 0; i < lines.size(); ++i)
+    {
+        if (!lines[i].trimmed().isEmpty())
+        {
+            ++lineNumber;
+        }
+    }
+    return lineNumber;
+}
+
+static bool checkCsvParserFuzz()
+{
+    const unsigned int rowNumber = 200;
+    QVector<float> referenceAngleArray;
+    QVector<float> measuredAngleArray;
+    generateSyntheticCapture(rowNumber, 75.0, 4, referenceAngleArray, measuredAngleArray);
+    QList<QByteArray> rows;
+    for (unsigned int i = 0; i < rowNumber; ++i)
+    {
+        rows.append(QByteArray::number(referenceAngleArray[i], 'g', 9) + "," + QByteArray::number(measuredAngleArray[i], 'g', 9));
+    }
+    const char alphabet[] = "0123456789.,-+eE \r\n\tx";
+    quint32 seed = 5;
+    unsigned int failureNumber = 0;
+    for (unsigned int iteration = 0; iteration < FUZZITERATIONNUMBER; ++iteration)
+    {
+        //only a few rows are mutated, the other ones must still be parsed to their exact values
+        QList<QByteArray> mutatedRows = rows;
+        QVector<bool> rowMutated(rowNumber, false);
+        const unsigned int mutationNumber = 1+nextRandom(&seed)%16;
+        for (unsigned int i = 0; i < mutationNumber; ++i)
+        {
+            const unsigned int row = nextRandom(&seed)%rowNumber;
+            QByteArray &mutated = mutatedRows[row];
+            rowMutated[row] = true;
+            const int position = mutated.isEmpty() ? 0 : nextRandom(&seed)%mutated.size();
+            switch (nextRandom(&seed)%4)
+            {
+            case 0:
+                if (!mutated.isEmpty())
+                {
+                    mutated[position] = alphabet[nextRandom(&seed)%(sizeof(alphabet)-1)];
+                }
+                break;
+            case 1:
+                mutated.insert(position, alphabet[nextRandom(&seed)%(sizeof(alphabet)-1)]);
+                break;
+            case 2:
+                mutated.remove(position, 1+nextRandom(&seed)%8);
+                break;
+            default:
+                mutated.truncate(position);
+                break;
+            }
+        }
+        const char *lineEnd = (iteration%2 == 0) ? "\n" : "\r\n";
+        QByteArray csv = QByteArray("Reference Angle [degree],Measured Angle [degree]") + lineEnd;
+        for (unsigned int i = 0; i < rowNumber; ++i)
+        {
+            csv.append(mutatedRows[i]);
+            //the last line end is dropped every fourth file
+            if (i+1 < rowNumber || iteration%4 < 2)
+            {
+                csv.append(lineEnd);
+            }
+        }
+        //the copy has no terminator, reads past the end are caught when the self check is built with -fsanitize=address
+        QVector<char> buffer(csv.size());
+        memcpy(buffer.data(), csv.constData(), csv.size());
+        QVector<float> parsedReferenceAngleArray;
+        QVector<float> parsedMeasuredAngleArray;
+        const bool loaded = loadCsvCapture(buffer.constData(), buffer.constData()+buffer.size(), 360.0,
+                                           parsedReferenceAngleArray, parsedMeasuredAngleArray, false);
+        const int expectedRowNumber = nonBlankLineNumber(csv.mid(csv.indexOf('\n')+1));
+        bool passed = (loaded == (expectedRowNumber > 0)) &&
+                      parsedReferenceAngleArray.size() == (loaded ? expectedRowNumber : 0) &&
+                      parsedMeasuredAngleArray.size() == parsedReferenceAngleArray.size();
+        int parsedRow = 0;
+        for (unsigned int i = 0; passed && i < rowNumber; ++i)
+        {
+            if (!rowMutated[i])
+            {
+                passed = parsedReferenceAngleArray[parsedRow] == referenceAngleArray[i] &&
+                         parsedMeasuredAngleArray[parsedRow] == measuredAngleArray[i];
+            }
+            parsedRow += nonBlankLineNumber(mutatedRows[i]);
+        }
+        if (!passed)
+        {
+            ++failureNumber;
+        }
+    }
+    return report(failureNumber == 0, QString("CSV parser with %1 mutated files").arg(FUZZITERATIONNUMBER), failureNumber);
+}
+
+static bool checkInvalidParameters()
+{
+    float angle = 0.0;
+    float angleError;
+    Harmonics harmonics;
+    bool passed = extractAngleErrorHarmonics(&angle, &angle, &angleError, 0,
+                                             &harmonics.h[0], &harmonics.h[1], &harmonics.h[2], &harmonics.h[3],
+                                             &harmonics.phi[0], &harmonics.phi[1], &harmonics.phi[2], &harmonics.phi[3]) == CALIBRATION_ERROR_INVALID_SIZE;
+    passed = passed && extractAngleErrorHarmonics(&angle, &angle, &angleError, 1,
+                                                  NULL, &harmonics.h[1], &harmonics.h[2], &harmonics.h[3],
+                                                  &harmonics.phi[0], &harmonics.phi[1], &harmonics.phi[2], &harmonics.phi[3]) == CALIBRATION_ERROR_NULL_POINTER;
+    const unsigned short rawAnglePair[2] = {0, 0};
+    passed = passed && extractAngleErrorHarmonicsFromRawData(rawAnglePair, 0, &angleError, 1,
+                                                             &harmonics.h[0], &harmonics.h[1], &harmonics.h[2], &harmonics.h[3],
+                                                             &harmonics.phi[0], &harmonics.phi[1], &harmonics.phi[2], &harmonics.phi[3]) == CALIBRATION_ERROR_INVALID_PARAMETER;
+    //a code outside of the full scale would give an angle error above 360 degree
+    const unsigned short outOfRangeAnglePair[2] = {0, 600};
+    passed = passed && extractAngleErrorHarmonicsFromRawData(outOfRangeAnglePair, 512, NULL, 1,
+                                                             &harmonics.h[0], &harmonics.h[1], &harmonics.h[2], &harmonics.h[3],
+                                                             &harmonics.phi[0], &harmonics.phi[1], &harmonics.phi[2], &harmonics.phi[3]) == CALIBRATION_ERROR_INVALID_PARAMETER;
+    return report(passed, "invalid parameters rejected", 0.0);
+}
+
+static QByteArray serverRequest(const char magic[4], quint32 sampleSource, quint32 fullScaleValue, quint32 lookupTableSize,
+                                quint32 sampleCount, quint32 ringOffset)
+{
+    QByteArray request(24, '\0');
+    uchar *requestData = reinterpret_cast<uchar *>(request.data());
+    memcpy(requestData, magic, 4);
+    qToLittleEndian<quint32>(sampleSource, requestData+4);
+    qToLittleEndian<quint32>(fullScaleValue, requestData+8);
+    qToLittleEndian<quint32>(lookupTableSize, requestData+12);
+    qToLittleEndian<quint32>(sampleCount, requestData+16);
+    qToLittleEndian<quint32>(ringOffset, requestData+20);
+    return request;
+}
+
+static float readFloat(const uchar *data)
+{
+    const quint32 bits = qFromLittleEndian<quint32>(data);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static bool waitForBytes(QLocalSocket &socket, qint64 size)
+{
+    while (socket.bytesAvailable() < size)
+    {
+        if (!socket.waitForReadyRead(SERVERTIMEOUT))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool sendServerRequest(QLocalSocket &socket, const QByteArray &request)
+{
+    socket.write(request);
+    while (socket.bytesToWrite() > 0)
+    {
+        if (!socket.waitForBytesWritten(SERVERTIMEOUT))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool readServerResponse(QLocalSocket &socket, ServerResponse *pResponse)
+{
+    if (!waitForBytes(socket, 48))
+    {
+        return false;
+    }
+    const QByteArray header = socket.read(48);
+    const uchar *headerData = reinterpret_cast<const uchar *>(header.constData());
+    pResponse->status = qFromLittleEndian<quint32>(headerData+4);
+    pResponse->sampleCount = qFromLittleEndian<quint32>(headerData+8);
+    pResponse->lookupTableSize = qFromLittleEndian<quint32>(headerData+12);
+    for (unsigned int k = 0; k < CALIBRATION_HARMONIC_NUMBER; ++k)
+    {
+        pResponse->harmonics.h[k] = readFloat(headerData+16+4*k);
+        pResponse->harmonics.phi[k] = readFloat(headerData+32+4*k);
+    }
+    const int lookupTableValueNumber = 7*pResponse->lookupTableSize;
+    if (memcmp(headerData, "MACA", 4) != 0 || !waitForBytes(socket, 4*lookupTableValueNumber))
+    {
+        return false;
+    }
+    const QByteArray lookupTables = socket.read(4*lookupTableValueNumber);
+    pResponse->lookupTables.resize(lookupTableValueNumber);
+    for (int i = 0; i < lookupTableValueNumber; ++i)
+    {
+        pResponse->lookupTables[i] = readFloat(reinterpret_cast<const uchar *>(lookupTables.constData())+4*i);
+    }
+    return true;
+}
+
+//same lookup tables as the daemon response, computed with the plain library functions
+static QVector<float> generateLookupTables(Harmonics harmonics, unsigned int lookupTableSize)
+{
+    QVector<float> lookupTableAngleArray(lookupTableSize);
+    for (unsigned int i = 0; i < lookupTableSize; ++i)
+    {
+        lookupTableAngleArray[i] = (float)i*360.0/(float)lookupTableSize;
+    }
+    QVector<float> lookupTables(7*lookupTableSize);
+    float *fittedArray = lookupTables.data();
+    generateAngleErrorLookupTableUsingFittedCurve(lookupTableAngleArray.data(), fittedArray, lookupTableSize,
+                                                  &harmonics.h[0], &harmonics.h[1], &harmonics.h[2], &harmonics.h[3],
+                                                  &harmonics.phi[0], &harmonics.phi[1], &harmonics.phi[2], &harmonics.phi[3]);
+    generateAngleErrorLookupTableUsingConstantsAndSlopes(lookupTableAngleArray.data(), fittedArray+lookupTableSize, fittedArray+2*lookupTableSize, lookupTableSize,
+                                                         &harmonics.h[0], &harmonics.h[1], &harmonics.h[2], &harmonics.h[3],
+                                                         &harmonics.phi[0], &harmonics.phi[1], &harmonics.phi[2], &harmonics.phi[3]);
+    generateAngleErrorLookupTableUsingCubicCoefficients(lookupTableAngleArray.data(), fittedArray+3*lookupTableSize, lookupTableSize,
+                                                        &harmonics.h[0], &harmonics.h[1], &harmonics.h[2], &harmonics.h[3],
+                                                        &harmonics.phi[0], &harmonics.phi[1], &harmonics.phi[2], &harmonics.phi[3]);
+    return lookupTables;
+}
+
+static bool checkServerResponse(QLocalSocket &socket, const QString &name, const Harmonics &expected)
+{
+    ServerResponse response;
+    if (!readServerResponse(socket, &response))
+    {
+        return report(false, name + ", no valid response", 0.0);
+    }
+    const QVector<float> expectedLookupTables = generateLookupTables(expected, SERVERLOOKUPTABLESIZE);
+    float deviation = harmonicsDeviation(expected, response.harmonics);
+    for (int i = 0; i < expectedLookupTables.size() && i < response.lookupTables.size(); ++i)
+    {
+        deviation = qMax(deviation, fabsf(response.lookupTables[i]-expectedLookupTables[i]));
+    }
+    return report(response.status == CALIBRATION_SUCCESS && response.sampleCount == SERVERSAMPLENUMBER &&
+                  response.lookupTableSize == SERVERLOOKUPTABLESIZE && response.lookupTables.size() == expectedLookupTables.size() &&
+                  deviation == 0.0, name, deviation);
+}
+
+//the daemon must answer a malformed request with a protocol error and close the connection
+static bool checkServerRejection(const QString &serverName, const QString &name, const QByteArray &request)
+{
+    QLocalSocket socket;
+    socket.connectToServer(serverName);
+    ServerResponse response;
+    const bool answered = socket.waitForConnected(SERVERTIMEOUT) && sendServerRequest(socket, request) &&
+                          readServerResponse(socket, &response);
+    const bool closed = (socket.state() == QLocalSocket::UnconnectedState) || socket.waitForDisconnected(SERVERTIMEOUT);
+    return report(answered && response.status == CALIBRATIONSERVER_ERROR_PROTOCOL && closed, name, 0.0);
+}
+
+//client side of the daemon round trip, runs in its own thread while the daemon runs in the event loop
+static bool runServerClient(const QString &serverName)
+{
+    QVector<float> referenceAngleArray;
+    QVector<float> measuredAngleArray;
+    generateSyntheticCapture(SERVERSAMPLENUMBER, 0.5, 6, referenceAngleArray, measuredAngleArray);
+    //same samples as raw codes and as little-endian payloads
+    const float rawToDegree = 360.0/(float)RAWFULLSCALEVALUE;
+    QVector<unsigned short> rawAnglePairs(2*SERVERSAMPLENUMBER);
+    QByteArray rawPayload(4*SERVERSAMPLENUMBER, '\0');
+    QByteArray degreePayload(8*SERVERSAMPLENUMBER, '\0');
+    uchar *rawPayloadData = reinterpret_cast<uchar *>(rawPayload.data());
+    uchar *degreePayloadData = reinterpret_cast<uchar *>(degreePayload.data());
+    quint32 bits;
+    for (unsigned int i = 0; i < SERVERSAMPLENUMBER; ++i)
+    {
+        rawAnglePairs[2*i] = (unsigned int)lroundf(referenceAngleArray[i]/rawToDegree)%RAWFULLSCALEVALUE;
+        rawAnglePairs[2*i+1] = (unsigned int)lroundf(measuredAngleArray[i]/rawToDegree)%RAWFULLSCALEVALUE;
+        qToLittleEndian<quint16>(rawAnglePairs[2*i], rawPayloadData+4*i);
+        qToLittleEndian<quint16>(rawAnglePairs[2*i+1], rawPayloadData+4*i+2);
+        memcpy(&bits, &referenceAngleArray[i], sizeof(bits));
+        qToLittleEndian<quint32>(bits, degreePayloadData+4*i);
+        memcpy(&bits, &measuredAngleArray[i], sizeof(bits));
+        qToLittleEndian<quint32>(bits, degreePayloadData+4*(SERVERSAMPLENUMBER+i));
+    }
+    Harmonics rawExpected;
+    extractAngleErrorHarmonicsFromRawData(rawAnglePairs.constData(), RAWFULLSCALEVALUE, NULL, SERVERSAMPLENUMBER,
+                                          &rawExpected.h[0], &rawExpected.h[1], &rawExpected.h[2], &rawExpected.h[3],
+                                          &rawExpected.phi[0], &rawExpected.phi[1], &rawExpected.phi[2], &rawExpected.phi[3]);
+    Harmonics degreeExpected;
+    extractAngleErrorHarmonics(referenceAngleArray.data(), measuredAngleArray.data(), NULL, SERVERSAMPLENUMBER,
+                               &degreeExpected.h[0], &degreeExpected.h[1], &degreeExpected.h[2], &degreeExpected.h[3],
+                               &degreeExpected.phi[0], &degreeExpected.phi[1], &degreeExpected.phi[2], &degreeExpected.phi[3]);
+    QLocalSocket socket;
+    socket.connectToServer(serverName);
+    if (!socket.waitForConnected(SERVERTIMEOUT))
+    {
+        return report(false, "calibration daemon connection, " + socket.errorString(), 0.0);
+    }
+    //the requests are sent back to back on the same connection
+    bool passed = sendServerRequest(socket, serverRequest("MACR", CalibrationServer::RawPayload, RAWFULLSCALEVALUE, SERVERLOOKUPTABLESIZE,
+                                                          SERVERSAMPLENUMBER, 0) + rawPayload);
+    passed = checkServerResponse(socket, "calibration daemon, raw payload", rawExpected) && passed;
+    passed = sendServerRequest(socket, serverRequest("MACR", CalibrationServer::DegreePayload, 0, SERVERLOOKUPTABLESIZE,
+                                                     SERVERSAMPLENUMBER, 0) + degreePayload) && passed;
+    passed = checkServerResponse(socket, "calibration daemon, degree payload", degreeExpected) && passed;
+    QSharedMemory sampleRing(serverName + "-samples");
+    if (sampleRing.attach() && sampleRing.lock())
+    {
+        memcpy(static_cast<char *>(sampleRing.data())+4*SERVERRINGOFFSET, rawPayload.constData(), rawPayload.size());
+        sampleRing.unlock();
+        passed = sendServerRequest(socket, serverRequest("MACR", CalibrationServer::RawSampleRing, RAWFULLSCALEVALUE, SERVERLOOKUPTABLESIZE,
+                                                         SERVERSAMPLENUMBER, SERVERRINGOFFSET)) && passed;
+        passed = checkServerResponse(socket, "calibration daemon, sample ring", rawExpected) && passed;
+        const int firstPartSize = 4*(SERVERSAMPLERINGSIZE-SERVERWRAPPEDRINGOFFSET);
+        if (sampleRing.lock())
+        {
+            memcpy(static_cast<char *>(sampleRing.data())+4*SERVERWRAPPEDRINGOFFSET, rawPayload.constData(), firstPartSize);
+            memcpy(sampleRing.data(), rawPayload.constData()+firstPartSize, rawPayload.size()-firstPartSize);
+            sampleRing.unlock();
+            passed = sendServerRequest(socket, serverRequest("MACR", CalibrationServer::RawSampleRing, RAWFULLSCALEVALUE, SERVERLOOKUPTABLESIZE,
+                                                             SERVERSAMPLENUMBER, SERVERWRAPPEDRINGOFFSET)) && passed;
+            passed = checkServerResponse(socket, "calibration daemon, wrapped sample ring", rawExpected) && passed;
+        }
+        else
+        {
+            passed = report(false, "calibration daemon, wrapped sample ring, " + sampleRing.errorString(), 0.0) && passed;
+        }
+        sampleRing.detach();
+    }
+    else
+    {
+        passed = report(false, "calibration daemon, sample ring, " + sampleRing.errorString(), 0.0) && passed;
+    }
+    socket.disconnectFromServer();
+    passed = checkServerRejection(serverName, "calibration daemon, malformed header",
+                                  serverRequest("MACX", CalibrationServer::RawPayload, RAWFULLSCALEVALUE, SERVERLOOKUPTABLESIZE,
+                                                SERVERSAMPLENUMBER, 0)) && passed;
+    //rejected from the header alone, the payload is never sent
+    passed = checkServerRejection(serverName, "calibration daemon, sample count above the ring size",
+                                  serverRequest("MACR", CalibrationServer::DegreePayload, 0, SERVERLOOKUPTABLESIZE,
+                                                SERVERSAMPLERINGSIZE+1, 0)) && passed;
+    return passed;
+}
+
+static bool checkCalibrationServer()
+{
+    const QString serverName = QString("ma-cal-generator-self-check-%1").arg(QCoreApplication::applicationPid());
+    CalibrationServer server(SERVERSAMPLERINGSIZE);
+    QString errorMessage;
+    if (!server.start(serverName, &errorMessage))
+    {
+        return report(false, "calibration daemon start, " + errorMessage, 0.0);
+    }
+    QFutureWatcher<bool> clientWatcher;
+    QEventLoop eventLoop;
+    QObject::connect(&clientWatcher, SIGNAL(finished()), &eventLoop, SLOT(quit()));
+    clientWatcher.setFuture(QtConcurrent::run(runServerClient, serverName));
+    eventLoop.exec();
+    return clientWatcher.result();
+}
+
+bool runSelfCheck(unsigned int maxSampleNumber)
+{
+    //the offsets cover no jump, errors wrapping around 0 degree (180 degree jump handling) and errors around 180 degree
+    const float angleErrorOffsets[] = {75.0, 0.5, 359.8, 180.0};
+    const unsigned int angleErrorOffsetNumber = sizeof(angleErrorOffsets)/sizeof(angleErrorOffsets[0]);
+    QVector<unsigned int> sampleNumbers;
+    for (unsigned int sampleNumber = 200; sampleNumber < maxSampleNumber; sampleNumber *= 10)
+    {
+        sampleNumbers.append(sampleNumber);
+    }
+    sampleNumbers.append(maxSampleNumber);
+    bool passed = checkInvalidParameters();
+    for (int i = 0; i < sampleNumbers.size(); ++i)
+    {
+        for (unsigned int j = 0; j < angleErrorOffsetNumber; ++j)
+        {
+            passed = checkExtraction(sampleNumbers[i], angleErrorOffsets[j]) && passed;
+            passed = checkRawData(sampleNumbers[i], angleErrorOffsets[j]) && passed;
+        }
+        passed = checkContext(sampleNumbers[i]) && passed;
+        passed = checkCsvParser(sampleNumbers[i], "\n") && passed;
+        passed = checkCsvParser(sampleNumbers[i], "\r\n") && passed;
+    }
+    for (unsigned int lookupTableSize = 4; lookupTableSize <= 256; lookupTableSize *= 2)
+    {
+        passed = checkLookupTables(lookupTableSize) && passed;
+    }
+    passed = checkCsvParserFuzz() && passed;
+    passed = checkCalibrationServer() && passed;
+    std::cout << (passed ? "All the checks passed" : "Some checks failed") << std::endl;
+    return passed;
+}
@@ -0,0 +1,55 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2017 Mathieu Kaelin for Monolithic Power Systems
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+#ifndef SELFCHECK_H
+#define SELFCHECK_H
+
+/**
+ * @file selfcheck.h
+ * @brief Deterministic randomized check of the numerical functions.
+ *
+ * Synthetic captures are generated from known harmonics with noise, a
+ * wrapping reference angle and angle error offsets which trigger the 180
+ * degree jump handling. The harmonics extraction is checked against the
+ * known harmonics, and its harmonics and centered angle error (from degrees
+ * and from raw codes) against a multi-pass double precision reference. Every
+ * alternative path (calibration context, dense lookup tables, cubic batch
+ * interpolation, parallel CSV parser) is checked against the reference
+ * functions. The CSV parser is also fed with randomly mutated files. The
+ * calibration daemon is started on a private local socket and checked with a
+ * client round trip for every sample source, a span wrapping around the end
+ * of the sample ring and rejected requests. The same seed always generates
+ * the same data.
+ */
+
+/**
+ * @brief Run all the checks and print the result of each one on the console.
+ *
+ * A QCoreApplication must exist, the daemon check runs an event loop.
+ *
+ * @param maxSampleNumber Size of the biggest synthetic capture, for example 10000000
+ * @return true if all the checks passed
+ */
+bool runSelfCheck(unsigned int maxSampleNumber);
+
+#endif // SELFCHECK_H